@@ -0,0 +1,398 @@
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "src/frame_arena.h"
+#include "src/job_system.h"
+#include "src/key_handler.h"
+#include "src/main_helper.h"
+#include "src/world.h"
+
+/** \class Bot
+ *  @brief Scripted input of a player, sent as key events to a KeyHandler.
+ *
+ * Holds jump all the time and walks in one direction. Turns around after a
+ * random time or when it didn't move horizontally for BLOCKED_TIME. The
+ * random times only depend on the seed.
+ */
+class Bot {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const sf::Int32 MIN_TURN_TIME = 1000, /**< Min ms until a turn */
+      MAX_TURN_TIME = 5000,                    /**< Max ms until a turn */
+      BLOCKED_TIME = 400; /**< ms without moving until a turn */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  KeyHandler key_handler;  /**< Gets the key events */
+  std::mt19937 random;     /**< Times of the turns */
+  sf::Keyboard::Key direction = sf::Keyboard::Right; /**< Held direction */
+  sf::Int32 next_turn = 0; /**< ms until the next turn */
+  sf::Int32 blocked = 0;   /**< ms without horizontal movement */
+  float last_x = 0;        /**< Horizontal position of the last step */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief Constructs a new Bot object and presses its first keys.
+   *
+   * @param player The player to control.
+   * @param world The world of the player.
+   * @param seed Seed of the turns.
+   * @param factor Time factor of one tick.
+   */
+  Bot(Characters::Player* player, World* world, sf::Uint32 seed, float factor)
+      : key_handler(nullptr, player, world), random(seed) {
+    this->last_x = player->getPosition().x;
+    send(sf::Keyboard::Space, true, factor);
+    send(this->direction, true, factor);
+    this->next_turn = std::uniform_int_distribution<sf::Int32>(
+        MIN_TURN_TIME, MAX_TURN_TIME)(this->random);
+  }
+
+  /**
+   * @brief Sends the keys for the next tick.
+   *
+   * @param x Horizontal position of the player.
+   * @param factor Time factor of the tick.
+   */
+  void step(float x, float factor) {
+    sf::Int32 ms = (sf::Int32)(factor * 100.f);
+    if (std::fabs(x - this->last_x) < .5f)
+      this->blocked += ms;
+    else
+      this->blocked = 0;
+    this->last_x = x;
+    this->next_turn -= ms;
+    if (this->next_turn > 0 && this->blocked < BLOCKED_TIME) return;
+
+    // Turn around
+    send(this->direction, false, factor);
+    this->direction = this->direction == sf::Keyboard::Right
+                          ? sf::Keyboard::Left
+                          : sf::Keyboard::Right;
+    send(this->direction, true, factor);
+    this->next_turn = std::uniform_int_distribution<sf::Int32>(
+        MIN_TURN_TIME, MAX_TURN_TIME)(this->random);
+    this->blocked = 0;
+  }
+
+ private:
+  /**
+   * @brief Sends a key event, like the replayer.
+   *
+   * @param key The key.
+   * @param pressed True for pressed, false for released.
+   * @param factor Time factor of the tick.
+   */
+  void send(sf::Keyboard::Key key, bool pressed, float factor) {
+    sf::Event event;
+    event.type = pressed ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+    std::memset(&event.key, 0, sizeof(event.key));
+    event.key.code = key;
+    if (pressed)
+      this->key_handler.keyPressed(event, factor);
+    else
+      this->key_handler.keyReleased(event, factor);
+  }
+};
+
+/** \class Batch
+ *  @brief Simulates many climbs of bots in headless worlds on all cores.
+ *
+ * Every run is an independent local World with its own seed and one Bot.
+ * Worker threads take the next run until all are done, each world is only
+ * touched by the thread that runs it. Worlds are stepped with a fixed factor
+ * without sleeping, so much faster than real time. A run ends when the player
+ * died or after the max number of ticks.
+ *
+ * The results of a run only depend on its seed and scenes, not on the number
+ * of threads.
+ */
+class Batch {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief Result of one run.
+   */
+  struct Run {
+    sf::Uint32 seed = 0;       /**< Seed of the world and the bot */
+    std::string scenes;        /**< Scene order, empty for random */
+    sf::Uint64 ticks = 0;      /**< Simulated ticks */
+    float height = 0;          /**< Max height above the start in px */
+    bool died = false;         /**< Whether the player died */
+    uint16_t coins = 0;        /**< Collected coins */
+    float update_mean = 0,     /**< Mean time of World::update() in us */
+        update_max = 0;        /**< Max time of World::update() in us */
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  sf::Vector2u size;         /**< Size of the worlds */
+  float factor;              /**< Time factor of one tick */
+  sf::Uint64 max_ticks;      /**< Ticks after which a run ends */
+  std::vector<Run> runs;     /**< All runs, written by the workers */
+  std::atomic<size_t> next;  /**< Index of the next run to simulate */
+  std::mutex costs_mutex;    /**< Locks costs */
+  std::vector<float> costs;  /**< Time of every World::update() in us */
+  double seconds = 0;        /**< Wall time of run() */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief Constructs a new Batch object.
+   *
+   * @param runs The runs to simulate (seed and scenes set).
+   * @param size Size of the worlds.
+   * @param factor Time factor of one tick.
+   * @param max_ticks Ticks after which a run ends.
+   */
+  Batch(const std::vector<Run>& runs, const sf::Vector2u& size, float factor,
+        sf::Uint64 max_ticks)
+      : size(size),
+        factor(factor),
+        max_ticks(max_ticks),
+        runs(runs),
+        next(0) {}
+
+  /**
+   * @brief Simulates all runs.
+   *
+   * @param threads Number of worker threads.
+   */
+  void run(unsigned int threads) {
+    // Shared textures and sounds must not be loaded by several threads
+    {
+      World world(this->size, World::State::Local);
+      world.loadResources();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; i++)
+      workers.push_back(std::thread(&Batch::work, this));
+    for (auto& worker : workers) worker.join();
+    this->seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    std::sort(this->costs.begin(), this->costs.end());
+  }
+
+  /**
+   * @brief Prints heights, deaths and the distribution of the update times.
+   *
+   * @param out The stream to write to.
+   */
+  void printSummary(std::ostream& out) const {
+    if (this->runs.empty()) return;
+
+    sf::Uint64 ticks = 0;
+    size_t deaths = 0;
+    std::vector<float> heights;
+    for (const Run& run : this->runs) {
+      ticks += run.ticks;
+      if (run.died) deaths++;
+      heights.push_back(run.height);
+    }
+    std::sort(heights.begin(), heights.end());
+    double mean = 0;
+    for (float height : heights) mean += height;
+    mean /= heights.size();
+
+    double simulated = (double)ticks * this->factor / 10.;
+    out << "Runs: " << this->runs.size() << ", " << ticks << " ticks ("
+        << simulated << " s simulated) in " << this->seconds << " s, "
+        << simulated / this->seconds << "x real time" << std::endl
+        << "Deaths: " << deaths << " ("
+        << 100. * deaths / this->runs.size() << " %)" << std::endl
+        << "Height in px: mean " << mean << ", p50 "
+        << percentile(heights, .5f) << ", p95 " << percentile(heights, .95f)
+        << ", max " << heights.back() << std::endl;
+    if (this->costs.empty()) return;
+    out << "World::update() in us: p50 " << percentile(this->costs, .5f)
+        << ", p95 " << percentile(this->costs, .95f) << ", p99 "
+        << percentile(this->costs, .99f) << ", max " << this->costs.back()
+        << std::endl;
+  }
+
+  /**
+   * @brief Writes one line per run as csv.
+   *
+   * @param out The stream to write to.
+   */
+  void writeCsv(std::ostream& out) const {
+    out << "seed,scenes,ticks,height,died,coins,update_mean_us,update_max_us"
+        << std::endl;
+    for (const Run& run : this->runs)
+      out << run.seed << "," << run.scenes << "," << run.ticks << ","
+          << run.height << "," << run.died << "," << run.coins << ","
+          << run.update_mean << "," << run.update_max << std::endl;
+  }
+
+ private:
+  /**
+   * @brief Main loop of a worker thread.
+   *
+   */
+  void work() {
+    std::vector<float> own_costs;
+    size_t i;
+    while ((i = this->next.fetch_add(1)) < this->runs.size())
+      simulate(this->runs[i], own_costs);
+
+    std::lock_guard<std::mutex> lock(this->costs_mutex);
+    this->costs.insert(this->costs.end(), own_costs.begin(), own_costs.end());
+  }
+
+  /**
+   * @brief Simulates one run.
+   *
+   * @param run The run, its results are set.
+   * @param costs The time of every update is added to it.
+   */
+  void simulate(Run& run, std::vector<float>& costs) {
+    // Same setup as the replayer
+    World* world = nullptr;
+    std::vector<char> scenes(run.scenes.begin(), run.scenes.end());
+    scenes.push_back('\0');
+    if (!run.scenes.empty())
+      world = new World(this->size, scenes.data(), World::State::Local);
+    else
+      world = new World(this->size, World::State::Local);
+    world->setSeed(run.seed);
+    Characters::Player* player =
+        new Characters::Player(Characters::Player::START_POSITION, true);
+    world->addPlayer(player);
+    world->init();
+
+    Bot bot(player, world, run.seed, this->factor);
+    float start_y = player->getPosition().y;
+    double total = 0;
+    while (run.ticks < this->max_ticks) {
+      bot.step(player->getPosition().x, this->factor);
+
+      auto start = std::chrono::steady_clock::now();
+      world->update(this->factor);
+      float cost = std::chrono::duration<float, std::micro>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+      FrameArena::get().reset();
+
+      costs.push_back(cost);
+      total += cost;
+      if (cost > run.update_max) run.update_max = cost;
+      run.ticks++;
+      run.height = std::max(run.height, start_y - player->getPosition().y);
+      if (player->getHP() == 0) {
+        run.died = true;
+        break;
+      }
+    }
+    run.coins = player->getCoins();
+    if (run.ticks > 0) run.update_mean = (float)(total / run.ticks);
+
+    delete world;
+  }
+
+  /**
+   * @brief Returns a percentile of sorted values.
+   *
+   * @param values The values, sorted and not empty.
+   * @param p The percentile, 0 to 1.
+   * @return float The value.
+   */
+  static float percentile(const std::vector<float>& values, float p) {
+    size_t index = (size_t)std::ceil(p * values.size());
+    return values[index > 0 ? index - 1 : 0];
+  }
+};
+
+int main(int argc, char** argv) {
+  std::map<std::string, char*> args = MainHelper::parseArgs(argc, argv);
+
+  if (args.count("help") > 0) {
+    std::cout << "Usage: heaven-batch.out [runs=100] [threads=0] [seed=1]"
+              << " [ticks=6000] [tick=13] [scenes=<each|a.xml,b.xml,...>]"
+              << " [width=1920] [height=1080] [out=<file.csv>]" << std::endl
+              << "  threads=0 uses one thread per core, scenes=each plays"
+              << " the scenes of the scene list in turns." << std::endl;
+    return 0;
+  }
+
+  size_t runs = (size_t)MainHelper::numberArg(args, "runs", 100, 1, 1000000);
+  unsigned int threads = (unsigned int)MainHelper::numberArg(
+      args, "threads", 0, 0, JobSystem::MAX_THREADS);
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  sf::Uint32 seed =
+      (sf::Uint32)MainHelper::numberArg(args, "seed", 1, 0, 0x7FFFFFFF);
+  sf::Uint64 ticks =
+      (sf::Uint64)MainHelper::numberArg(args, "ticks", 6000, 1, 100000000);
+  float factor =
+      (float)MainHelper::numberArg(args, "tick", 13, 1, 1000) / 100.f;
+  sf::Vector2u size(
+      (unsigned int)MainHelper::numberArg(args, "width", 1920, 1, 0xFFFF),
+      (unsigned int)MainHelper::numberArg(args, "height", 1080, 1, 0xFFFF));
+
+  // Scene order of each run
+  std::vector<std::string> scene_orders(1, "");
+  if (args.count("scenes") > 0 && strcmp(args["scenes"], "each") == 0) {
+    scene_orders.clear();
+    std::ifstream scene_list(World::SCENE_LIST_FILE);
+    std::string line;
+    while (std::getline(scene_list, line))
+      if (line.size() > 0 && line[0] != '#')
+        // Relative to Ressources/Scenes like the scenes option
+        scene_orders.push_back(line.substr(line.rfind('/') + 1));
+    if (scene_orders.empty()) {
+      std::cerr << "Error: No scenes in " << World::SCENE_LIST_FILE
+                << std::endl;
+      return 1;
+    }
+  } else if (args.count("scenes") > 0) {
+    scene_orders[0] = args["scenes"];
+  }
+
+  std::vector<Batch::Run> batch_runs(runs);
+  for (size_t i = 0; i < runs; i++) {
+    batch_runs[i].seed = seed + (sf::Uint32)i;
+    batch_runs[i].scenes = scene_orders[i % scene_orders.size()];
+  }
+
+  std::cout << "Simulating " << runs << " runs on " << threads
+            << " threads..." << std::endl;
+  Batch batch(batch_runs, size, factor, ticks);
+  batch.run(threads);
+  batch.printSummary(std::cout);
+
+  if (args.count("out") > 0) {
+    std::ofstream file(args["out"], std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+      std::cerr << "Error while opening: " << args["out"] << std::endl;
+      return 1;
+    }
+    batch.writeCsv(file);
+    std::cout << "Runs written to " << args["out"] << std::endl;
+  }
+  return 0;
+}
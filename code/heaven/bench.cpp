@@ -0,0 +1,408 @@
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+#include "src/Network/client.h"
+#include "src/alloc_tracker.h"
+#include "src/frame_arena.h"
+#include "src/main_helper.h"
+#include "src/profiler.h"
+#include "src/world.h"
+
+/** \class Bench
+ *  @brief Micro and macro benchmarks of the hot paths.
+ *
+ * Every benchmark is run a few times to warm up and then measured
+ * Bench::samples times. Each sample is the time of one run divided by the
+ * operations done in it. The summary of all benchmarks is written as json, so
+ * two runs can be compared.
+ */
+class Bench {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t WARMUP = 3; /**< Unmeasured runs before the samples */
+
+  static const size_t PACKET_BATCH = 256; /**< Packets per decode run */
+
+  static constexpr float FACTOR = 1.3f; /**< Time factor of one tick (13 ms,
+                                        min loop time of the client) */
+
+  /**
+   * @brief Summary of one benchmark.
+   */
+  struct Result {
+    std::string name;            /**< Name including parameters */
+    size_t ops = 0;              /**< Operations per sample */
+    std::vector<double> samples; /**< ns per operation, sorted */
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  size_t samples;             /**< Measured runs per benchmark */
+  std::string filter;         /**< Only benchmarks containing this run */
+  std::vector<Result> results; /**< All finished benchmarks */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  Bench(size_t samples, const std::string& filter)
+      : samples(samples), filter(filter) {}
+
+  /**
+   * @brief Measures a benchmark if it matches the filter.
+   *
+   * @param name Name of the benchmark.
+   * @param ops Operations done by one call of run.
+   * @param prepare Called before every run, not measured. May be empty.
+   * @param run The measured code.
+   */
+  void measure(const std::string& name, size_t ops,
+               const std::function<void()>& prepare,
+               const std::function<void()>& run) {
+    if (name.find(this->filter) == std::string::npos) return;
+
+    Result result;
+    result.name = name;
+    result.ops = ops;
+    for (size_t i = 0; i < WARMUP + this->samples; i++) {
+      if (prepare) prepare();
+      auto start = std::chrono::steady_clock::now();
+      run();
+      auto end = std::chrono::steady_clock::now();
+      if (i < WARMUP) continue;
+      result.samples.push_back(
+          (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end -
+                                                                       start)
+              .count() /
+          (double)ops);
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    std::cerr << name << ": " << result.samples[result.samples.size() / 2]
+              << " ns" << std::endl;
+    this->results.push_back(result);
+  }
+
+  /**
+   * @brief Writes all results as json.
+   *
+   * Per benchmark: min, max, mean, median, p95, stddev and the half width of
+   * the 95 % confidence interval of the mean, all in ns per operation.
+   *
+   * @param out The stream to write to.
+   */
+  void writeJson(std::ostream& out) const {
+    out << "{\"samples\":" << this->samples << ",\"debug\":"
+#ifdef DEBUG
+        << "true"
+#else
+        << "false"
+#endif
+        << ",\"benchmarks\":[";
+    for (size_t i = 0; i < this->results.size(); i++) {
+      const Result& result = this->results[i];
+      const std::vector<double>& s = result.samples;
+      double mean = 0, variance = 0;
+      for (double v : s) mean += v;
+      mean /= s.size();
+      for (double v : s) variance += (v - mean) * (v - mean);
+      if (s.size() > 1) variance /= s.size() - 1;
+      double stddev = std::sqrt(variance);
+      size_t p95 = (size_t)std::ceil(0.95 * s.size()) - 1;
+
+      if (i > 0) out << ",";
+      out << "{\"name\":\"" << result.name << "\",\"unit\":\"ns\",\"ops\":"
+          << result.ops << ",\"min\":" << s.front() << ",\"max\":" << s.back()
+          << ",\"mean\":" << mean << ",\"median\":" << s[s.size() / 2]
+          << ",\"p95\":" << s[p95] << ",\"stddev\":" << stddev
+          << ",\"ci95\":" << 1.96 * stddev / std::sqrt((double)s.size())
+          << "}";
+    }
+    out << "]}" << std::endl;
+  }
+
+  // ----------------------------------------- //
+  /* Benchmarks */
+  // ----------------------------------------- //
+
+  /**
+   * @brief World::moveCharacters with n characters and m grounds.
+   */
+  void moveCharacters(size_t n, size_t m) {
+    sf::Vector2u size(1920, 1080);
+    World world(size, World::State::Local);
+
+    // Grounds must be sorted bottom to top
+    for (size_t i = 0; i < m; i++)
+      world.addGround(new Grounds::SolidGround(
+          sf::FloatRect((float)((i * 337) % (size.x - 200)),
+                        1100.f - (float)i * 40.f, 200, 20)));
+
+    std::vector<Characters::Character*> characters;
+    std::vector<sf::Vector2f> positions;
+    for (size_t i = 0; i < n; i++) {
+      positions.push_back(
+          sf::Vector2f((float)((i * 151) % (size.x - 100) + 20),
+                       1000.f - (float)((i * 97) % (m * 40 + 1))));
+      Characters::Player* player = new Characters::Player(positions[i], true);
+      if (i % 2 == 0) player->setMoveDirRight(FACTOR);
+      characters.push_back(player);
+    }
+
+    measure("moveCharacters/n=" + std::to_string(n) + "/m=" + std::to_string(m),
+            1,
+            [&]() {
+              for (size_t i = 0; i < n; i++) {
+                characters[i]->setPosition(positions[i]);
+                characters[i]->update(FACTOR);
+              }
+            },
+            [&]() {
+              {
+                FrameVector<Characters::Character*> frame(characters.begin(),
+                                                          characters.end());
+                world.moveCharacters(FACTOR, frame);
+              }
+              FrameArena::get().reset();
+            });
+
+    for (auto c : characters) delete c;
+  }
+
+  /**
+   * @brief World::loadScene for every scene in the scene list, including the
+   * commented ones, and the spawn.
+   */
+  void loadScenes() {
+    std::vector<std::string> files;
+    files.push_back(World::SPAWN_SCENE_FILE);
+    std::ifstream scene_list(World::SCENE_LIST_FILE);
+    std::string line;
+    while (std::getline(scene_list, line)) {
+      size_t start = line.find("Ressources/");
+      if (start != std::string::npos) files.push_back(line.substr(start));
+    }
+
+    World world(sf::Vector2u(1920, 1080), World::State::Local);
+    for (const std::string& file : files) {
+      std::string name = file.substr(file.rfind('/') + 1);
+      measure("loadScene/" + name, 1, std::function<void()>(), [&]() {
+        World::scene_t scene = world.loadScene(file, 0);
+        for (auto g : std::get<0>(scene)) delete g;
+        for (auto e : std::get<1>(scene)) delete e;
+        for (auto c : std::get<2>(scene)) delete c;
+      });
+    }
+  }
+
+  /**
+   * @brief Client with access to the packet builders and handleReceived().
+   */
+  class PacketClient : public Network::Client {
+   public:
+    using Network::Client::Client;
+    using Network::NetworkManager::addGroundPacket;
+    using Network::NetworkManager::addPlayerPacket;
+    using Network::NetworkManager::groundSetPosPacket;
+    using Network::NetworkManager::handleReceived;
+    using Network::NetworkManager::playerChangeStatePacket;
+    using Network::NetworkManager::playerSetPosPacket;
+
+    void receive(sf::Packet* packet) {
+      this->receive_tcp_packets.push(std::make_pair((uint16_t)0, packet));
+    }
+    void release(sf::Packet* packet) { this->packet_pool.release(packet); }
+  };
+
+  /**
+   * @brief The packet builders and the decoding of received packets by a
+   * client.
+   */
+  void packets() {
+    World* world = new World(sf::Vector2u(1920, 1080), World::State::Client);
+    world->addPlayer(
+        new Characters::Player(Characters::Player::START_POSITION, true));
+    PacketClient* client = new PacketClient(
+        world, world->getCharacterFactory(), world->getCollectablesFactory());
+
+    // Remote players and grounds the updates are for
+    const sf::Uint16 PLAYERS = 8;
+    const sf::Uint32 GROUNDS = 64;
+    Characters::Player player(Characters::Player::START_POSITION, false);
+    Grounds::SolidGround ground(sf::FloatRect(100, 100, 200, 20));
+    for (sf::Uint16 id = 1; id <= PLAYERS; id++)
+      client->receive(client->addPlayerPacket(id, &player));
+    for (sf::Uint32 id = 0; id < GROUNDS; id++)
+      client->receive(client->addGroundPacket(id, &ground));
+    client->handleReceived();
+
+    std::vector<sf::Packet*> batch;
+    auto build = [&]() {
+      for (size_t i = 0; i < PACKET_BATCH; i++) {
+        sf::Vector2f position(100.f + i, 200.f - i);
+        if (i % 4 == 0)
+          batch.push_back(client->groundSetPosPacket(i % GROUNDS, position));
+        else if (i % 4 == 1)
+          batch.push_back(client->playerChangeStatePacket(
+              i % PLAYERS + 1, Characters::Character::State::Walk));
+        else
+          batch.push_back(client->playerSetPosPacket(i % PLAYERS + 1, position));
+      }
+    };
+
+    measure("packet/build", PACKET_BATCH, std::function<void()>(), [&]() {
+      build();
+      for (auto packet : batch) client->release(packet);
+      batch.clear();
+    });
+
+    measure("packet/addGround", PACKET_BATCH, std::function<void()>(), [&]() {
+      for (size_t i = 0; i < PACKET_BATCH; i++)
+        client->release(client->addGroundPacket(i, &ground));
+    });
+
+    measure("packet/handleReceived", PACKET_BATCH,
+            [&]() {
+              build();
+              for (auto packet : batch) client->receive(packet);
+              batch.clear();
+            },
+            [&]() { client->handleReceived(); });
+
+    delete client;
+    delete world;
+  }
+
+  /**
+   * @brief Full headless ticks of a local world with a jumping player.
+   */
+  void worldSteps(size_t ticks) {
+    World* world = new World(sf::Vector2u(1920, 1080), World::State::Local);
+    world->setSeed(0);
+    Characters::Player* player =
+        new Characters::Player(Characters::Player::START_POSITION, true);
+    world->addPlayer(player);
+    world->init();
+
+    measure("world/update/ticks=" + std::to_string(ticks), ticks,
+            std::function<void()>(), [&]() {
+              for (size_t i = 0; i < ticks; i++) {
+                player->setJump(true);
+                world->update(FACTOR);
+                FrameArena::get().reset();
+              }
+            });
+
+    delete world;
+  }
+
+  // ----------------------------------------- //
+  /* Checks */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Checks that ticks of a local world with an idle player don't
+   * allocate once the world settled.
+   *
+   * Prints the allocations per Profiler phase.
+   *
+   * @param warmup Ticks before counting.
+   * @param ticks Counted ticks.
+   * @return bool True if no tick allocated.
+   */
+  static bool steadyAllocations(size_t warmup, size_t ticks) {
+    World* world = new World(sf::Vector2u(1920, 1080), World::State::Local);
+    world->setSeed(0);
+    world->addPlayer(
+        new Characters::Player(Characters::Player::START_POSITION, true));
+    world->init();
+    for (size_t i = 0; i < warmup; i++) {
+      world->update(FACTOR);
+      FrameArena::get().reset();
+    }
+
+    AllocTracker::Counter start[Profiler::PHASES];
+    for (size_t i = 0; i < Profiler::PHASES; i++)
+      start[i] = AllocTracker::get((uint8_t)i);
+    for (size_t i = 0; i < ticks; i++) {
+      world->update(FACTOR);
+      FrameArena::get().reset();
+    }
+    AllocTracker::Counter end[Profiler::PHASES];
+    for (size_t i = 0; i < Profiler::PHASES; i++)
+      end[i] = AllocTracker::get((uint8_t)i);
+
+    sf::Uint64 total = 0;
+    for (size_t i = 0; i < Profiler::PHASES; i++) {
+      AllocTracker::Counter counter = end[i] - start[i];
+      total += counter.allocations;
+      if (counter.allocations == 0) continue;
+      std::cout << Profiler::NAMES[i] << ": " << counter.allocations
+                << " allocations (" << counter.bytes << " bytes) in "
+                << ticks << " ticks" << std::endl;
+    }
+    delete world;
+
+    std::cout << (total == 0 ? "OK" : "FAILED") << ": " << total
+              << " allocations in " << ticks << " steady ticks." << std::endl;
+    return total == 0;
+  }
+};
+
+int main(int argc, char** argv) {
+  std::map<std::string, char*> args = MainHelper::parseArgs(argc, argv);
+
+  if (args.count("help") > 0) {
+    std::cout << "Usage: heaven-bench.out [samples=30] [filter=<name part>]"
+              << " [out=bench.json]" << std::endl
+              << "       heaven-bench.out check_allocs" << std::endl;
+    return 0;
+  }
+
+  if (args.count("check_allocs") > 0)
+    return Bench::steadyAllocations(300, 100) ? 0 : 1;
+
+  size_t samples = 30;
+  if (args.count("samples") > 0) {
+    try {
+      samples = std::stoul(args["samples"]);
+    } catch (const std::exception&) {
+      samples = 0;
+    }
+    if (samples == 0) {
+      std::cerr << "Error: samples must be a positive number." << std::endl;
+      return 1;
+    }
+  }
+  std::string out = args.count("out") > 0 ? args["out"] : "bench.json";
+
+  Bench bench(samples, args.count("filter") > 0 ? args["filter"] : "");
+
+  // Micro
+  bench.moveCharacters(10, 50);
+  bench.moveCharacters(100, 200);
+  bench.moveCharacters(1000, 500);
+  bench.packets();
+
+  // Macro
+  bench.loadScenes();
+  bench.worldSteps(100);
+  bench.worldSteps(1000);
+
+  std::ofstream file(out, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Error while opening: " << out << std::endl;
+    return 1;
+  }
+  bench.writeJson(file);
+  std::cout << "Results written to " << out << std::endl;
+  return 0;
+}
@@ -4,13 +4,45 @@
 
 #include "src/Network/client.h"
 #include "src/Network/host.h"
+#include "src/frame_arena.h"
 #include "src/hud.h"
+#include "src/job_system.h"
 #include "src/key_handler.h"
 #include "src/log_window.h"
 #include "src/main_helper.h"
+#include "src/profiler.h"
+#include "src/profiler_overlay.h"
+#include "src/recorder.h"
+#include "src/replayer.h"
+#include "src/trace.h"
 #include "src/world.h"
 
 int main(int argc, char** argv) {
+  // ----------------------------------------- //
+  /* Args */
+  // ----------------------------------------- //
+
+  std::map<std::string, char*> args = MainHelper::parseArgs(argc, argv);
+
+  if (args.count("replay") > 0) {
+    // Headless, as fast as possible
+    Replayer replayer;
+    if (!replayer.load(args["replay"])) return 1;
+    sf::Uint64 until =
+        (sf::Uint64)MainHelper::numberArg(args, "until", 0, 0, 0x7FFFFFFF);
+    Recorder::Keyframe last;
+    // Only the local part of a game, always from the first tick (see Replayer)
+    bool valid = replayer.run(until, &last);
+    std::cout << "Replayed " << last.tick << " of " << replayer.getTickCount()
+              << " ticks (" << replayer.getPacketCount()
+              << " received packets not replayed). Player at "
+              << last.position.x << "/"
+              << last.position.y << " with " << last.hp << " hp and "
+              << last.coins << " coins, checksum " << last.checksum << "."
+              << std::endl;
+    return valid ? 0 : 1;
+  }
+
   // ----------------------------------------- //
   /* Window */
   // ----------------------------------------- //
@@ -22,12 +54,6 @@ int main(int argc, char** argv) {
 
   HelpOverlay help_overlay(window, false);
 
-  // ----------------------------------------- //
-  /* Args */
-  // ----------------------------------------- //
-
-  std::map<std::string, char*> args = MainHelper::parseArgs(argc, argv);
-
   if (args.count("ip") > 0) {
     Grounds::NetworkButton::press(true);
   }
@@ -35,6 +61,13 @@ int main(int argc, char** argv) {
   bool predefined_scenes = false;
   if (args.count("scenes") > 0) predefined_scenes = true;
 
+  Network::LinkSimulator::Conditions link_conditions =
+      MainHelper::parseNetsim(args);
+
+  // Frames with more work are captured by the profiler
+  sf::Int32 budget =
+      (sf::Int32)MainHelper::numberArg(args, "budget", 16, 1, 1000);
+
 #ifdef DEBUG
   std::cout << "Args: " << std::endl;
   for (auto c : args) std::cout << c.first << ":" << c.second << std::endl;
@@ -48,11 +81,35 @@ int main(int argc, char** argv) {
   Characters::Player* player =
       new Characters::Player(Characters::Player::START_POSITION, true);
 
+  // The world splits the scene order in place
+  std::string scenes = predefined_scenes ? args["scenes"] : "";
+
   World* world = nullptr;
   if (predefined_scenes)
     world = new World(window, player, args["scenes"]);
   else
     world = new World(window, player);
+  if (args.count("seed") > 0)
+    world->setSeed(
+        (sf::Uint32)MainHelper::numberArg(args, "seed", 0, 0, 0x7FFFFFFF));
+  if (args.count("activation") > 0)
+    world->setActivationDistance((float)MainHelper::numberArg(
+        args, "activation", (long)World::ACTIVATION_DISTANCE, 0, 1000000));
+  if (args.count("threads") > 0)
+    world->setThreads((unsigned int)MainHelper::numberArg(
+        args, "threads", 1, 0, JobSystem::MAX_THREADS));
+
+  // Must be created before the world loads the first scenes
+  Recorder* recorder = nullptr;
+  if (args.count("record") > 0) {
+    recorder = new Recorder(args["record"], world, scenes);
+    if (!recorder->isOpen()) {
+      delete recorder;
+      delete world;
+      delete window;
+      return 1;
+    }
+  }
 
   world->init();
 
@@ -80,6 +137,20 @@ int main(int argc, char** argv) {
   LogWindow log_window(world);
   log_window.close();  // Set comment to show window
 
+  Profiler profiler(budget);
+  if (args.count("profile") > 0 && !profiler.setCaptureFile(args["profile"])) {
+    delete recorder;
+    delete world;
+    delete window;
+    return 1;
+  }
+  ProfilerOverlay profiler_overlay(window);
+
+  // Recording is toggled with Trace::TRACE_KEY or started right away
+  Trace trace(args.count("trace") > 0 ? args["trace"] : "trace.json");
+  Trace::setThreadName("main");
+  if (args.count("trace") > 0) trace.start();
+
   float window_movement = 0;
 
   bool newly_connected = false;
@@ -92,6 +163,8 @@ int main(int argc, char** argv) {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
 
   while (window->isOpen()) {
+    profiler.beginFrame();
+
     // Change animation
     if (animation_clock.getElapsedTime().asMilliseconds() > 80) {
       world->toggleAnimation();
@@ -99,8 +172,10 @@ int main(int argc, char** argv) {
     }
 
     // If elapsed time is to low, sleep to "fix" to small factor
-    if (main_clock.getElapsedTime().asMicroseconds() < 13000)
+    if (main_clock.getElapsedTime().asMicroseconds() < 13000) {
+      Profiler::Scope scope(Profiler::Phase::Sleep);
       sf::sleep(sf::microseconds(13000));
+    }
     // Get time of and restart main_clock
     sf::Int32 ms = main_clock.restart().asMilliseconds();
     float factor = ((float)(ms)) / 100.0f;
@@ -108,50 +183,57 @@ int main(int argc, char** argv) {
       factor = 0.f;
       newly_connected = false;
     }
+    if (recorder) recorder->beginTick(factor);
 
     // ----------------------------------------- //
     /* Event Switch */
     // ----------------------------------------- //
 
-    sf::Event event;
-    while (window->pollEvent(event)) {
-      switch (event.type) {
-        case sf::Event::Closed:
-          window->close();
-          break;
+    {
+      Profiler::Scope scope(Profiler::Phase::Events);
+      sf::Event event;
+      while (window->pollEvent(event)) {
+        switch (event.type) {
+          case sf::Event::Closed:
+            window->close();
+            break;
 
-        case sf::Event::KeyPressed:
+          case sf::Event::KeyPressed:
 
 #ifdef DEBUG
-          if (event.key.code == sf::Keyboard::F4) {
-            // ----------------------------------------- //
-            /* Debug */
-            // ----------------------------------------- //
-            player->setHP(5);
-
-            new Buyables::JumpBoost(player, 10);
-          } else if (event.key.code == sf::Keyboard::F5) {
-            if (manager) {
-              // Set HP max for all players
-              auto all_players = world->getPlayers();
-              for (auto p : all_players) {
-                p->heal(p->MAX_HP);
+            if (event.key.code == sf::Keyboard::F4) {
+              // ----------------------------------------- //
+              /* Debug */
+              // ----------------------------------------- //
+              player->setHP(5);
+
+              new Buyables::JumpBoost(player, 10);
+            } else if (event.key.code == sf::Keyboard::F5) {
+              if (manager) {
+                // Set HP max for all players
+                auto all_players = world->getPlayers();
+                for (auto p : all_players) {
+                  p->heal(p->MAX_HP);
+                }
               }
             }
-          }
 #endif
-          if (!key_handler.keyPressed(event, factor)) {
-            delete window;
-            return 0;
-          }
-          break;
+            if (recorder) recorder->recordKey(event);
+            if (!key_handler.keyPressed(event, factor)) {
+              delete recorder;
+              delete window;
+              return 0;
+            }
+            break;
 
-        case sf::Event::KeyReleased:
-          key_handler.keyReleased(event, factor);
-          break;
+          case sf::Event::KeyReleased:
+            if (recorder) recorder->recordKey(event);
+            key_handler.keyReleased(event, factor);
+            break;
 
-        default:
-          break;
+          default:
+            break;
+        }
       }
     }
 
@@ -161,6 +243,7 @@ int main(int argc, char** argv) {
 
     // Movement etc. (also drawing all objects inside world)
     window_movement += world->update(factor) * -1.f;
+    if (recorder) recorder->endTick(world);
     float vertical_movement =
         window_movement * .1f;  // Makes the window movement "smooth"
 
@@ -168,9 +251,13 @@ int main(int argc, char** argv) {
       vertical_movement += window_movement * window_movement / 2000;
     }
     window_movement -= vertical_movement;
-    world->draw(window);
+    {
+      Profiler::Scope scope(Profiler::Phase::Draw);
+      world->draw(window);
+    }
 
     if (manager) {
+      Profiler::Scope scope(Profiler::Phase::Network);
       manager->update();
     } else if (Grounds::NetworkButton::isPressed()) {
       window->setVisible(false);
@@ -191,6 +278,9 @@ int main(int argc, char** argv) {
         // Setup host
         world->setState(World::State::Host);
         Network::Host* host = new Network::Host(world);
+        host->simulateLinks(link_conditions);
+        if (args.count("stats") > 0) host->setStatsFile(args["stats"]);
+        host->setRecorder(recorder);
         host->start();
         manager = host;
 
@@ -237,6 +327,9 @@ int main(int argc, char** argv) {
         Network::Client* client =
             new Network::Client(world, world->getCharacterFactory(),
                                 world->getCollectablesFactory());
+        client->simulateLinks(link_conditions);
+        if (args.count("stats") > 0) client->setStatsFile(args["stats"]);
+        client->setRecorder(recorder);
 
         uint8_t i = 0;
         for (; i < 10; i++) {
@@ -269,6 +362,10 @@ int main(int argc, char** argv) {
                          std::to_string(vertical_movement));
       std::vector<std::string> logs = world->getLogText();
       for (std::string& line : logs) log_window.addLine(line);
+      if (manager) {
+        logs = manager->getLogText();
+        for (std::string& line : logs) log_window.addLine(line);
+      }
     }
 
     // Adjust view and background for movement
@@ -281,17 +378,28 @@ int main(int argc, char** argv) {
     sf::Listener::setPosition(audio_pos);
 
     // HUD
-    hud.drawPoints(vertical_movement * -1, player->getPosition().y * -1);
-    hud.drawHP(vertical_movement * -1, player->getHP());
-    hud.drawCoins(vertical_movement * -1, (int)player->getCoins());
-
-    if (key_handler.showHelp()) help_overlay.draw();
+    {
+      Profiler::Scope scope(Profiler::Phase::HUD);
+      hud.drawPoints(vertical_movement * -1, player->getPosition().y * -1);
+      hud.drawHP(vertical_movement * -1, player->getHP());
+      hud.drawCoins(vertical_movement * -1, (int)player->getCoins());
+
+      if (key_handler.showHelp()) help_overlay.draw();
+      if (key_handler.showProfiler()) profiler_overlay.draw(&profiler);
+    }
 
     // Window stuff
-    window->display();
+    {
+      Profiler::Scope scope(Profiler::Phase::Display);
+      window->display();
+    }
 
     if (log_window.isOpen()) log_window.update();
+
+    FrameArena::get().reset();
+    profiler.endFrame();
   }
+  delete recorder;
   delete world;
   delete window;
   return 0;
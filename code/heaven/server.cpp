@@ -0,0 +1,238 @@
+#include <SFML/System.hpp>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "src/Network/host.h"
+#include "src/frame_arena.h"
+#include "src/main_helper.h"
+#include "src/profiler.h"
+#include "src/trace.h"
+#include "src/world.h"
+
+static std::atomic<bool> running(true); /**< Cleared by SIGINT/SIGTERM */
+
+/**
+ * @brief Ends the tick loops, so everything is cleaned up and written.
+ *
+ * @param signal The received signal.
+ */
+static void stop(int signal) { running = false; }
+
+/**
+ * @brief One race of the server with its own world and host, ticked by its
+ * own thread.
+ */
+struct Room {
+  size_t index = 0;               /**< Index of the room, port + index */
+  World* world = nullptr;         /**< World of the race */
+  Network::Host* host = nullptr;  /**< Host of the world */
+  std::string profile;            /**< Capture file of the profiler or empty */
+  bool failed = false;            /**< Whether the room stopped on an error */
+};
+
+/**
+ * @brief Inserts the index of a room before the extension of a file, if
+ * there is more than one room.
+ *
+ * @param file The file, e.g. stats.csv.
+ * @param index The index of the room.
+ * @param rooms The number of rooms.
+ * @return std::string The file of the room, e.g. stats_1.csv.
+ */
+static std::string roomFile(const std::string& file, size_t index,
+                            size_t rooms) {
+  if (rooms < 2) return file;
+  size_t dot = file.rfind('.');
+  if (dot == std::string::npos || file.find('/', dot) != std::string::npos)
+    dot = file.size();
+  return file.substr(0, dot) + "_" + std::to_string(index) + file.substr(dot);
+}
+
+/**
+ * @brief Fixed tick loop of a room, runs until the server is stopped.
+ *
+ * @param room The room.
+ * @param tick Time of a tick in ms.
+ * @param rooms The number of rooms.
+ */
+static void runRoom(Room* room, sf::Int32 tick, size_t rooms) {
+  Trace::setThreadName(rooms > 1 ? "room " + std::to_string(room->index)
+                                 : "main");
+
+  // Ticks with more work than one tick are captured (one profiler per thread)
+  Profiler profiler(tick);
+  if (!room->profile.empty() && !profiler.setCaptureFile(room->profile)) {
+    room->failed = true;
+    running = false;
+    return;
+  }
+
+  float factor = ((float)tick) / 100.0f;
+  sf::Clock clock;
+  sf::Int64 next_tick = 0;  // In us since start
+  while (running) {
+    profiler.beginFrame();
+    room->world->update(factor);
+    {
+      Profiler::Scope scope(Profiler::Phase::Network);
+      room->host->update();
+    }
+
+    // Sleep until next tick
+    next_tick += (sf::Int64)tick * 1000;
+    sf::Int64 remaining = next_tick - clock.getElapsedTime().asMicroseconds();
+    if (remaining > 0) {
+      Profiler::Scope scope(Profiler::Phase::Sleep);
+      sf::sleep(sf::microseconds(remaining));
+    } else if (remaining < (sf::Int64)tick * -10000)
+      // More than 10 ticks behind -> don't try to catch up
+      next_tick = clock.getElapsedTime().asMicroseconds();
+    FrameArena::get().reset();
+    profiler.endFrame();
+  }
+}
+
+/**
+ * @brief Deletes the hosts and worlds of all rooms.
+ *
+ * @param rooms The rooms.
+ */
+static void deleteRooms(std::vector<Room>& rooms) {
+  for (Room& room : rooms) {
+    delete room.host;
+    delete room.world;
+  }
+  rooms.clear();
+}
+
+int main(int argc, char** argv) {
+  // ----------------------------------------- //
+  /* Args */
+  // ----------------------------------------- //
+
+  std::map<std::string, char*> args = MainHelper::parseArgs(argc, argv);
+
+  if (args.count("help") > 0) {
+    std::cout << "Usage: heaven-server.out [port=" << Network::Host::TCP_PORT
+              << "] [race=<distance>] [scenes=<a.xml,b.xml,...>]"
+              << " [max_players=" << Network::Host::MAX_PLAYERS << "]"
+              << " [tick=<ms>] [width=1920] [height=1080]"
+              << " [max_lag=" << Network::Host::MAX_LAG << "]"
+              << " [activation=" << (int)World::ACTIVATION_DISTANCE << "]"
+              << " [threads=1] [rooms=1]"
+              << " [stats=<file>] [profile=<file>] [trace=<file>]"
+              << " [netsim=delay=<ms>,jitter=<ms>,dist=<uniform|normal|"
+                 "exponential>,loss=<0..1>,retransmit=<ms>,reorder=<0..1>,"
+                 "bandwidth=<bytes/s>,seed=<n>]"
+              << std::endl;
+    std::cout << "  rooms=<n> runs n races on the ports port to port + n - 1,"
+              << " each on its own thread." << std::endl;
+    return 0;
+  }
+
+  uint16_t port = (uint16_t)MainHelper::numberArg(
+      args, "port", Network::Host::TCP_PORT, 1, 0xFFFF);
+  uint16_t race =
+      (uint16_t)MainHelper::numberArg(args, "race", 0, 0, 0xFFFF);
+  size_t max_players = (size_t)MainHelper::numberArg(
+      args, "max_players", Network::Host::MAX_PLAYERS, 1, 0xFFFF);
+  // Same step as the inputs of clients by default
+  sf::Int32 tick = (sf::Int32)MainHelper::numberArg(
+      args, "tick", Network::Host::SEND_UPDATE_INTERVAL, 1, 1000);
+  // Scenes are laid out relative to the window size of the clients
+  sf::Vector2u size(
+      (unsigned int)MainHelper::numberArg(args, "width", 1920, 1, 0xFFFF),
+      (unsigned int)MainHelper::numberArg(args, "height", 1080, 1, 0xFFFF));
+  sf::Int32 max_lag = (sf::Int32)MainHelper::numberArg(
+      args, "max_lag", Network::Host::MAX_LAG, 1, 600000);
+  Network::LinkSimulator::Conditions link_conditions =
+      MainHelper::parseNetsim(args);
+  size_t rooms_count = (size_t)MainHelper::numberArg(
+      args, "rooms", 1, 1, 0xFFFF - (long)port + 1);
+  // Enemies of a large world are updated by several threads (per room)
+  unsigned int threads = (unsigned int)MainHelper::numberArg(
+      args, "threads", 1, 0, JobSystem::MAX_THREADS);
+  float activation = (float)MainHelper::numberArg(
+      args, "activation", (long)World::ACTIVATION_DISTANCE, 0, 1000000);
+
+  // ----------------------------------------- //
+  /* Rooms (World & Host) */
+  // ----------------------------------------- //
+
+  std::vector<Room> rooms(rooms_count);
+  for (size_t i = 0; i < rooms_count; i++) {
+    Room& room = rooms[i];
+    room.index = i;
+
+    // The scene order is split in place
+    std::vector<char> scenes;
+    if (args.count("scenes") > 0) {
+      char* arg = args["scenes"];
+      scenes.assign(arg, arg + strlen(arg) + 1);
+    }
+    if (!scenes.empty())
+      room.world = new World(size, scenes.data(), World::State::Host);
+    else
+      room.world = new World(size, World::State::Host);
+    // Shared textures and sounds must not be loaded by several rooms at once
+    if (i == 0) room.world->loadResources();
+    room.world->setActivationDistance(activation);
+    room.world->setThreads(threads);
+    room.world->init();
+
+    uint16_t room_port = (uint16_t)(port + i);
+    room.host =
+        new Network::Host(room.world, Network::Host::UDP_PORT, room_port);
+    room.host->setMaxPlayers(max_players);
+    room.host->setMaxLag(Network::Host::MAX_QUEUE_BYTES, max_lag);
+    room.host->simulateLinks(link_conditions);
+    if (args.count("stats") > 0 &&
+        !room.host->setStatsFile(roomFile(args["stats"], i, rooms_count))) {
+      deleteRooms(rooms);
+      return 1;
+    }
+    if (!room.host->start()) {
+      deleteRooms(rooms);
+      return 1;
+    }
+    if (race > 0) room.world->setRaceDistance(race);
+    if (args.count("profile") > 0)
+      room.profile = roomFile(args["profile"], i, rooms_count);
+  }
+
+  // Written on exit (SIGINT / SIGTERM)
+  Trace trace(args.count("trace") > 0 ? args["trace"] : "trace.json");
+  Trace::setThreadName("main");
+  if (args.count("trace") > 0) trace.start();
+
+  if (rooms_count > 1)
+    std::cout << "Server running " << rooms_count << " rooms on ports " << port
+              << " to " << port + rooms_count - 1 << " with a tick of " << tick
+              << " ms." << std::endl;
+  else
+    std::cout << "Server running on port " << port << " with a tick of "
+              << tick << " ms." << std::endl;
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Fixed Tick Loops */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+  std::signal(SIGINT, stop);
+  std::signal(SIGTERM, stop);
+  if (rooms_count == 1) {
+    runRoom(&rooms[0], tick, rooms_count);
+  } else {
+    std::vector<std::thread> room_threads;
+    for (Room& room : rooms)
+      room_threads.push_back(std::thread(runRoom, &room, tick, rooms_count));
+    for (auto& room_thread : room_threads) room_thread.join();
+  }
+
+  bool failed = false;
+  for (const Room& room : rooms) failed = failed || room.failed;
+  deleteRooms(rooms);
+  return failed ? 1 : 0;
+}
@@ -39,6 +39,8 @@ Immortality::Immortality(Characters::Character* character, uint16_t run_time)
 Immortality::Immortality(uint16_t run_time)
     : Buyable(getTexture()), time(run_time) {
   this->sprite.setScale(OBJECT_SIZE.x / 50, OBJECT_SIZE.y / 50);
+
+  this->timer.setCallback([this]() { this->is_active = false; });
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -51,8 +53,6 @@ Type Immortality::getType() const { return Type::Immortality; }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Immortality::update(float factor) {
   if (!this->is_active) return;  // Do nothing if inactive
-  if (this->clock.getElapsedTime().asSeconds() >= this->time)
-    this->is_active = false;
 
   // Check if hp of character was increased and overwrite otherwise
   if (this->character->getHP() > this->base_hp)
@@ -74,7 +74,7 @@ void Immortality::assignTo(Characters::Character* character) {
   // Change drawing stuff
   this->sprite.setScale(ICON_SIZE.x / 50, ICON_SIZE.y / 50);
 
-  this->clock.restart();
+  this->timer.start(character->getTimers(), (sf::Uint32)this->time * 1000);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include "../timer_wheel.h"
 #include "buyable.h"
 
 namespace Characters {
@@ -42,7 +43,7 @@ class Immortality : public Buyable {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  private:
-  sf::Clock clock;     /**< Clock for setting inactive after time */
+  Timer timer;         /**< Sets inactive after time */
   const uint16_t time; /**< Stores the time to run for current instance */
   static sf::Texture texture; /**< The texture for all immortality buyables */
 
@@ -30,6 +30,11 @@ JumpBoost::JumpBoost(Characters::Character* character, uint16_t run_time)
 JumpBoost::JumpBoost(uint16_t run_time)
     : Buyable(getTexture()), time(run_time) {
   this->sprite.setScale(OBJECT_SIZE.x / 50, OBJECT_SIZE.y / 50);
+
+  this->timer.setCallback([this]() {
+    this->is_active = false;
+    this->character->modifyJumpPower(-1 * JUMP_MODIFY);
+  });
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,17 +42,6 @@ JumpBoost::JumpBoost(uint16_t run_time)
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 Type JumpBoost::getType() const { return Type::JumpBoost; }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/* update() */
-///////////////////////////////////////////////////////////////////////////////////////////////////
-void JumpBoost::update(float factor) {
-  if (!this->is_active) return;  // Do nothing if inactive
-  if (this->clock.getElapsedTime().asSeconds() >= this->time) {
-    this->is_active = false;
-    this->character->modifyJumpPower(-1 * JUMP_MODIFY);
-  }
-}
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* assignTo() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -60,7 +54,7 @@ void JumpBoost::assignTo(Characters::Character* character) {
   // Change drawing stuff
   this->sprite.setScale(ICON_SIZE.x / 50, ICON_SIZE.y / 50);
 
-  this->clock.restart();
+  this->timer.start(character->getTimers(), (sf::Uint32)this->time * 1000);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
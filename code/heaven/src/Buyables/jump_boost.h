@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../timer_wheel.h"
 #include "buyable.h"
 
 namespace Characters {
@@ -35,7 +36,7 @@ class JumpBoost : public Buyable {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  private:
-  sf::Clock clock;     /**< Clock for setting inactive after time */
+  Timer timer;         /**< Sets inactive after time */
   const uint16_t time; /**< The time to run for the current jump boost */
 
   static sf::Texture texture; /**< Texture for all jump boost buyables */
@@ -69,8 +70,6 @@ class JumpBoost : public Buyable {
 
   Type getType() const override;
 
-  void update(float factor) override;
-
   /**
    * @brief Gets the price of an immortality buyable.
    *
@@ -11,6 +11,8 @@
 
 #include "bullet.h"
 
+#include "../../job_system.h"
+
 namespace Bullets {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -42,7 +44,8 @@ void Bullet::update(float factor) {
   // Check collision with players
   for (auto p : this->all_player) {
     if (p->getHP() > 0 && p->getGlobalBounds().intersects(getGlobalBounds())) {
-      p->takeDamage(this->DAMAGE);
+      // Players are shared by all enemies updated in parallel
+      JobSystem::defer([p]() { p->takeDamage(Bullet::DAMAGE); });
       this->destroyed = true;
     }
   }
@@ -70,11 +70,7 @@ class Bullet : public sf::Sprite {
   Bullet(sf::Vector2f start, sf::Vector2f movement,
          std::vector<Characters::Player*>& players)
       : movement(movement), moved_distance(0), all_player(players) {
-    if (this->texture.getSize().x == 0)
-      if (!this->texture.loadFromFile(TEXTURE_FILE)) {
-        std::cerr << "Could not load file: " << TEXTURE_FILE << std::endl;
-        exit(1);
-      }
+    loadTexture();
     setTexture(this->texture);
     setTextureRect(sf::IntRect(0, 0, 31, 31));
 
@@ -91,6 +87,20 @@ class Bullet : public sf::Sprite {
   /* Other Methods */
   // ----------------------------------------- //
 
+  /**
+   * @brief Loads the texture if not done yet.
+   *
+   * Bullets are created while enemies are updated in parallel, so shooters
+   * load it up front.
+   */
+  static void loadTexture() {
+    if (texture.getSize().x == 0)
+      if (!texture.loadFromFile(TEXTURE_FILE)) {
+        std::cerr << "Could not load file: " << TEXTURE_FILE << std::endl;
+        exit(1);
+      }
+  }
+
   /** @fn update
    * Updates everything needed.
    *
@@ -45,6 +45,9 @@ Character::Character(sf::Vector2f position)
     : movement(this->MAX_ABS_FALL_SPEED),
       default_texture(new sf::Texture()),
       hp(MAX_HP) {
+  this->damage_timer.setCallback(
+      [this]() { setColor(sf::Color(255, 255, 255, 255)); });
+
   if (this->footsteps_buffer.getDuration().asMicroseconds() == 0)
     if (!this->footsteps_buffer.loadFromFile(FOOTSTEPS_FILE)) exit(1);
   this->footsteps.setBuffer(this->footsteps_buffer);
@@ -96,7 +99,7 @@ bool Character::setJump(bool value) {
     movement.current_speed = 0.f;
     movement.applyForce(this->jump_power);
     this->on_ground = false;
-    this->jump_clock.restart();
+    this->jump_time = 0;
     this->jump.play();
     return true;
   }
@@ -129,13 +132,6 @@ void Character::setMoveDirLeft(float factor) {
 /* update() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Character::update(float factor) {
-  // Damage color
-  if (this->damage_colored &&
-      this->damage_clock.getElapsedTime().asMilliseconds() > 250) {
-    setColor(sf::Color(255, 255, 255, 255));
-    this->damage_colored = false;
-  }
-
   if (this->state == State::Walk) {
     if (this->footsteps.getStatus() != sf::Sound::Status::Playing)
       this->footsteps.play();
@@ -171,14 +167,14 @@ void Character::draw(sf::RenderWindow* window) const {
 void Character::updateMovement(float factor) {
   // Vertical movement
   this->movement.applyGravity(factor);
+  this->jump_time += factor * 100.f;
   if (this->keeps_jumping && this->can_keep_jumping) {
     // The following statement calculates the force which should push the
     // Character in the air because it is currently jumping and wants to jump
     // higher. Depending on the time passed since it started jumping, the force
     // will be lower (linear i think).
     float force = JUMP_ACCEL * HIGH_JUMP_MULTIPLIER *
-                  (1 - (this->jump_clock.getElapsedTime().asMilliseconds() /
-                        this->MAX_JUMP_HIGHER_TIME_MS));
+                  (1 - (this->jump_time / this->MAX_JUMP_HIGHER_TIME_MS));
     this->movement.applyForce(force, factor);
   }
 }
@@ -260,33 +256,66 @@ sf::FloatRect Character::getVerticalMove(float factor) const {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 bool Character::canMoveTo(
     sf::FloatRect new_global_bounds,
-    std::vector<Grounds::Ground*> possible_colliding_grounds,
-    std::vector<Grounds::Ground*>* collided_grounds,
+    const std::vector<Grounds::Ground*>& possible_colliding_grounds,
+    FrameVector<Grounds::Ground*>* collided_grounds,
     bool* collided_head) const {
   for (Grounds::Ground* g : possible_colliding_grounds) {
-    if (g->getGlobalBounds().intersects(new_global_bounds)) {  // Intersecting
-      if (!g->canCollide((const Character*)this)) {  // Not allowed to collide
-
-        // Check if head collided
-        sf::FloatRect head = new_global_bounds;
-        head.height = 1;
-
-        if (collided_head) {
-          if (head.intersects(g->getGlobalBounds()))  // Collision on head
-            *collided_head = true;
-          else
-            *collided_head = false;
-        }
+    sf::FloatRect ground_bounds = g->getGlobalBounds();
+    if (ground_bounds.intersects(new_global_bounds))  // Intersecting
+      if (!passGround(g, ground_bounds, new_global_bounds, collided_grounds,
+                      collided_head))
+        return false;
+  }
+
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* canMoveTo() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Character::canMoveTo(const sf::FloatRect& new_global_bounds,
+                          const ComponentTable<Grounds::Ground>& grounds,
+                          FrameVector<Grounds::Ground*>* collided_grounds,
+                          bool* collided_head) const {
+  // Only the bounds are read for grounds that are not hit
+  const sf::FloatRect* bounds = grounds.bounds.data();
+  for (size_t i = 0; i < grounds.size(); i++) {
+    if (bounds[i].intersects(new_global_bounds))  // Intersecting
+      if (!passGround(grounds.entities[i], bounds[i], new_global_bounds,
+                      collided_grounds, collided_head))
         return false;
-      } else if (collided_grounds) {
-        collided_grounds->push_back(g);
-      }
-    }
   }
 
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* passGround() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Character::passGround(Grounds::Ground* g,
+                           const sf::FloatRect& ground_bounds,
+                           const sf::FloatRect& new_global_bounds,
+                           FrameVector<Grounds::Ground*>* collided_grounds,
+                           bool* collided_head) const {
+  if (!g->canCollide((const Character*)this)) {  // Not allowed to collide
+
+    // Check if head collided
+    sf::FloatRect head = new_global_bounds;
+    head.height = 1;
+
+    if (collided_head) {
+      if (head.intersects(ground_bounds))  // Collision on head
+        *collided_head = true;
+      else
+        *collided_head = false;
+    }
+    return false;
+  } else if (collided_grounds) {
+    collided_grounds->push_back(g);
+  }
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* setPosition() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -328,6 +357,34 @@ void Character::setHorizontalMovement(int value) {
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getMoveState() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Character::MoveState Character::getMoveState() const {
+  MoveState move_state;
+  move_state.position = getPosition();
+  move_state.vertical_speed = this->movement.current_speed;
+  move_state.jump_time = this->jump_time;
+  move_state.horizontal_movement = this->horizontal_movement;
+  move_state.on_ground = this->on_ground;
+  move_state.keeps_jumping = this->keeps_jumping;
+  move_state.can_keep_jumping = this->can_keep_jumping;
+  return move_state;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setMoveState() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Character::setMoveState(const MoveState& move_state) {
+  setPosition(move_state.position);
+  this->movement.current_speed = move_state.vertical_speed;
+  this->jump_time = move_state.jump_time;
+  this->horizontal_movement = move_state.horizontal_movement;
+  this->on_ground = move_state.on_ground;
+  this->keeps_jumping = move_state.keeps_jumping;
+  this->can_keep_jumping = move_state.can_keep_jumping;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* setOnGround() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -344,7 +401,7 @@ void Character::setOnGround(bool value) {
 /* setState() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Character::setState(State state) {
-  if (!this->is_local) {
+  if (!this->is_local && !this->driven_by_input) {
     if (this->state == State::Jump &&
         (state == State::Walk || state == State::Idle)) {
       touchGround();
@@ -368,9 +425,9 @@ void Character::takeDamage(int damage) {
   else if (this->hp > Player::MAX_HP)
     this->hp = Player::MAX_HP;
 
-  this->damage_clock.restart();
-  this->damage_colored = true;
-  setColor(this->DAMAGE_COLOR);
+  // Reset by the callback of damage_timer
+  this->damage_timer.start(this->timers, DAMAGE_COLOR_TIME);
+  if (this->damage_timer.isRunning()) setColor(this->DAMAGE_COLOR);
   this->movement.current_speed = 0.f;
   this->movement.applyForce(-15.f);
 }
@@ -17,6 +17,9 @@
 
 #include "../Buyables/buyable.h"
 #include "../Collectables/collectable.h"
+#include "../component_table.h"
+#include "../frame_arena.h"
+#include "../timer_wheel.h"
 #include "character_helper.h"
 #include "vert_movement.h"
 
@@ -25,6 +28,7 @@ class Ground;
 }  // namespace Grounds
 
 namespace Network {
+class NetworkManager;
 class Host;
 class Client;
 }  // namespace Network
@@ -41,6 +45,23 @@ namespace Characters {
 class Character : public sf::Sprite {
  public:
   enum class State : uint8_t { Idle, Walk, Jump, Shoot, Die, Dead };
+
+  /**
+   * @brief Everything needed to repeat the movement of a Character.
+   *
+   * This is used for client side prediction to rewind to a state received
+   * from the host.
+   */
+  struct MoveState {
+    sf::Vector2f position;          /**< Position */
+    float vertical_speed = 0,       /**< Current vertical speed */
+        jump_time = 0;              /**< Time in ms since jump started */
+    int8_t horizontal_movement = 0; /**< Horizontal movement */
+    bool on_ground = false,         /**< Whether on ground */
+        keeps_jumping = false,      /**< Whether wants to jump higher */
+        can_keep_jumping = true;    /**< Whether can jump higher */
+  };
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Constant Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -62,6 +83,8 @@ class Character : public sf::Sprite {
       MAX_HP; /**< The maximum health points for this Character */
   static const sf::Color
       DAMAGE_COLOR; /**< Color for "animating" taking damage */
+  static const sf::Uint32
+      DAMAGE_COLOR_TIME = 250; /**< Time in ms DAMAGE_COLOR is shown */
 
   static const std::string
       FOOTSTEPS_FILE, /**< Path to the file with sound for footsteps */
@@ -72,9 +95,13 @@ class Character : public sf::Sprite {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  protected:
-  VertMovement movement; /**< VertMovement object */
-  sf::Clock jump_clock,  /**< The Clock for jump timing */
-      damage_clock;      /**< The Clock for "animating" taking damage */
+  VertMovement movement;  /**< VertMovement object */
+  TimerWheel* timers = nullptr; /**< Timers of the World of this Character */
+  Network::NetworkManager* network =
+      nullptr; /**< Network of the World of this Character, if any */
+  Timer damage_timer; /**< Runs while colored because of taking damage */
+  float jump_time = 0;    /**< Time in ms since jump started. Counted by
+                          updateMovement() so it can be replayed. */
   sf::Texture* default_texture =
       nullptr; /**< The Texture used when no other one is specified*/
   sf::Vector2f fixed_move; /**< Can be set to move the Character in a fixed
@@ -87,12 +114,15 @@ class Character : public sf::Sprite {
       can_keep_jumping = true, /**< Whether the Character can try to jump higher
                                (false when character jumps
                                against ceiling) */
-      damage_colored = false, /**< Indicates whether this Character is currently
-                              colored differently because
-                              of taking damage */
-      is_local = true;        /**< Determines whether this Character is a local.
+      is_local = true,        /**< Determines whether this Character is a local.
                               This is used for network multiplayer and only applied to
                               players. */
+      driven_by_input = false, /**< Whether this remote Character is moved by
+                               received inputs (host side of client
+                               prediction) */
+      awake = true;            /**< Whether the World updates, moves and
+                               animates this Character (false when far away
+                               from all players) */
   int8_t horizontal_movement = 0, /**< Movement value between -1 and +1
                                   etermining the movement
                                   direction with display dimensions */
@@ -312,15 +342,30 @@ class Character : public sf::Sprite {
    * @param[out] collided_head Pointer to bool for writing whether this
    *             Characters head collided.
    * @param[out] collided_grounds Apointer to write that the Character is
-   *             colliding with.
+   *             colliding with. Only valid until the end of the frame.
    * @return True if Character can move there; false otherwise.
    */
   virtual bool canMoveTo(
       sf::FloatRect new_global_bounds,
-      std::vector<Grounds::Ground*> possible_colliding_grounds,
-      std::vector<Grounds::Ground*>* collided_grounds,
+      const std::vector<Grounds::Ground*>& possible_colliding_grounds,
+      FrameVector<Grounds::Ground*>* collided_grounds,
       bool* collided_head) const;
 
+  /**
+   * @brief Same as canMoveTo() above, but reads the ground bounds from a
+   * synced table instead of every Ground.
+   *
+   * @param new_global_bounds The new global_bounds.
+   * @param grounds The grounds, synced with their current bounds.
+   * @param[out] collided_grounds See above.
+   * @param[out] collided_head See above.
+   * @return True if Character can move there; false otherwise.
+   */
+  bool canMoveTo(const sf::FloatRect& new_global_bounds,
+                 const ComponentTable<Grounds::Ground>& grounds,
+                 FrameVector<Grounds::Ground*>* collided_grounds,
+                 bool* collided_head) const;
+
   virtual void setPosition(const sf::Vector2f& position);
 
   virtual void setPosition(float x, float y) {
@@ -347,6 +392,39 @@ class Character : public sf::Sprite {
 
   virtual int getHP() const { return this->hp; };
 
+  /**
+   * @brief Sets the timers to use, set when added to a World.
+   *
+   * @param timers The timers of the World.
+   */
+  void setTimers(TimerWheel* timers) { this->timers = timers; }
+
+  /**
+   * @brief Sets the network to apply changes to, set by the World.
+   *
+   * @param network The network of the World or nullptr.
+   */
+  void setNetwork(Network::NetworkManager* network) { this->network = network; }
+
+  /**
+   * @brief Wakes this Character up or puts it to sleep.
+   *
+   * Stops the footsteps when falling asleep, since update() isn't called
+   * anymore.
+   *
+   * @param awake Whether awake.
+   */
+  void setAwake(bool awake) {
+    this->awake = awake;
+    if (!awake) this->footsteps.stop();
+  }
+
+  bool isAwake() const { return this->awake; }
+
+  TimerWheel* getTimers() const { return this->timers; }
+
+  Network::NetworkManager* getNetwork() const { return this->network; }
+
   virtual void setHP(int hp);
 
   virtual bool canKeepJumping() const { return this->can_keep_jumping; }
@@ -388,6 +466,35 @@ class Character : public sf::Sprite {
 
   virtual bool onGround() const { return this->on_ground; }
 
+  bool keepsJumping() const { return this->keeps_jumping; }
+
+  /**
+   * @brief Returns everything needed to repeat the movement.
+   *
+   * @return MoveState The current movement state.
+   */
+  MoveState getMoveState() const;
+
+  /**
+   * @brief Rewinds the movement to a state.
+   *
+   * This won't change the character state or send anything over network.
+   *
+   * @param move_state The movement state to apply.
+   */
+  void setMoveState(const MoveState& move_state);
+
+  /**
+   * @brief Sets whether this remote Character is moved by received inputs.
+   *
+   * If true, changes of the state won't apply any movement.
+   *
+   * @param value Whether driven by input.
+   */
+  void setDrivenByInput(bool value) { this->driven_by_input = value; }
+
+  bool isDrivenByInput() const { return this->driven_by_input; }
+
   /**
    * @brief Sets whether this characer is on ground.
    *
@@ -432,5 +539,24 @@ class Character : public sf::Sprite {
    * @param value The value to change.
    */
   void modifyJumpPower(float value) { this->jump_power += value; }
+
+  // ----------------------------------------- //
+  /* Private Methods */
+  // ----------------------------------------- //
+ private:
+  /**
+   * @brief Checks a ground that intersects the new bounds for canMoveTo().
+   *
+   * @param g The ground.
+   * @param ground_bounds The global bounds of g.
+   * @param new_global_bounds The new global bounds of this Character.
+   * @param[out] collided_grounds Gets g if this Character can pass it.
+   * @param[out] collided_head Whether the head collided, if blocked.
+   * @return True if g doesn't block the movement; false otherwise.
+   */
+  bool passGround(Grounds::Ground* g, const sf::FloatRect& ground_bounds,
+                  const sf::FloatRect& new_global_bounds,
+                  FrameVector<Grounds::Ground*>* collided_grounds,
+                  bool* collided_head) const;
 };
 }  // namespace Characters
\ No newline at end of file
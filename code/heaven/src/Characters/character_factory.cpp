@@ -38,7 +38,7 @@ Character* Factory::createCharacter(Type t,
 Enemy* Factory::createEnemy(EnemyType t, const sf::Vector2f& position) const {
   switch (t) {
     case EnemyType::Walker:
-      return new Walker(position, this->players, this->grounds, this->window);
+      return new Walker(position, this->players, this->grounds, this->size);
       break;
 
     case EnemyType::Shooter:
@@ -29,7 +29,7 @@ class Factory {
  private:
   const std::vector<Grounds::Ground*>& grounds; /**< Reference to vector with all grounds */
   std::vector<Player*>& players; /**< Reference to vector with all players */
-  const sf::RenderWindow* window; /**< Pointer to the window */
+  sf::Vector2u size; /**< Size of the world */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -44,11 +44,11 @@ class Factory {
    * 
    * @param grounds All grounds in the world.
    * @param players All players in the world.
-   * @param window The used window.
+   * @param size The size of the world.
    */
   Factory(const std::vector<Grounds::Ground*>& grounds, std::vector<Player*>& players,
-          const sf::RenderWindow* window)
-      : grounds(grounds), players(players), window(window) {}
+          const sf::Vector2u& size)
+      : grounds(grounds), players(players), size(size) {}
 
   // ----------------------------------------- //
   /* Create Methods */
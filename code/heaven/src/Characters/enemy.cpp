@@ -12,6 +12,7 @@
 #include "enemy.h"
 
 #include "../Network/host.h"
+#include "../job_system.h"
 
 namespace Characters {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -51,12 +52,10 @@ Player* Enemy::getNearestPlayer() {
 void Enemy::setState(State state) {
   Character::setState(state);
 
-  // Apply to network
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doEnemyChangeState(this);
-    }
+  // Apply to network (after a parallel update, in order of the enemies)
+  if (this->is_local && this->network && this->network->isHost()) {
+    Network::Host* host = this->network->asHost();
+    JobSystem::defer([host, this]() { host->doEnemyChangeState(this); });
   }
 }
 
@@ -66,12 +65,10 @@ void Enemy::setState(State state) {
 void Enemy::setHorizontalMovement(int value) {
   Character::setHorizontalMovement(value);
 
-  // Apply to network
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doEnemyHorizontalDir(this);
-    }
+  // Apply to network (after a parallel update, in order of the enemies)
+  if (this->is_local && this->network && this->network->isHost()) {
+    Network::Host* host = this->network->asHost();
+    JobSystem::defer([host, this]() { host->doEnemyHorizontalDir(this); });
   }
 }
 
@@ -80,12 +77,10 @@ void Enemy::setHorizontalMovement(int value) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Enemy::die() {
   Character::die();
-  // Apply to network
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doEnemyDie(this);
-    }
+  // Apply to network (after a parallel update, in order of the enemies)
+  if (this->is_local && this->network && this->network->isHost()) {
+    Network::Host* host = this->network->asHost();
+    JobSystem::defer([host, this]() { host->doEnemyDie(this); });
   }
 }
 }  // namespace Characters
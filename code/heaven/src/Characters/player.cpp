@@ -139,16 +139,8 @@ void Player::move(const sf::Vector2f& offset) {
 void Player::takeDamage(int damage) {
   Character::takeDamage(damage);
 
-  // Apply to network
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doPlayerTakeDamage(this, damage);
-    } else {
-      ((Network::Client*)Network::NetworkManager::getInstance())
-          ->doPlayerTakeDamage(this, damage);
-    }
-  }
+  // Sent by flushNetwork()
+  if (this->is_local && this->network) this->pending_damage += damage;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -157,13 +149,13 @@ void Player::takeDamage(int damage) {
 void Player::heal(uint8_t new_hp) {
   setHP(new_hp);
 
-  if (Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost())
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doPlayerHeal(this, new_hp);
+  if (this->network) {
+    // Damage taken before must arrive before the new hp
+    flushNetwork();
+    if (this->network->isHost())
+      this->network->asHost()->doPlayerHeal(this, new_hp);
     else
-      ((Network::Client*)Network::NetworkManager::getInstance())
-          ->doPlayerHeal(this, new_hp);
+      this->network->asClient()->doPlayerHeal(this, new_hp);
   }
 }
 
@@ -173,16 +165,8 @@ void Player::heal(uint8_t new_hp) {
 void Player::setState(State state) {
   Character::setState(state);
 
-  // Apply to network
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doPlayerChangeState(this);
-    } else {
-      ((Network::Client*)Network::NetworkManager::getInstance())
-          ->doPlayerChangeState(this);
-    }
-  }
+  // Sent by flushNetwork()
+  if (this->is_local && this->network) this->state_dirty = true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -191,15 +175,46 @@ void Player::setState(State state) {
 void Player::setHorizontalMovement(int value) {
   Character::setHorizontalMovement(value);
 
-  if (this->is_local && Network::NetworkManager::getInstance()) {
-    if (Network::NetworkManager::getInstance()->isHost()) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doPlayerHorizontalDir(this);
-    } else {
-      ((Network::Client*)Network::NetworkManager::getInstance())
-          ->doPlayerHorizontalDir(this);
-    }
+  // Sent by flushNetwork()
+  if (this->is_local && this->network) this->direction_dirty = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* flushNetwork() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Player::flushNetwork() {
+  if (!this->network) return;
+  Network::Host* host = this->network->asHost();
+  Network::Client* client = this->network->asClient();
+
+  // Only the final values, if they differ from the sent ones
+  if (this->state_dirty && getState() != this->sent_state) {
+    this->sent_state = getState();
+    if (host)
+      host->doPlayerChangeState(this);
+    else
+      client->doPlayerChangeState(this);
+  }
+  if (this->direction_dirty && getDirection() != this->sent_direction) {
+    this->sent_direction = getDirection();
+    if (host)
+      host->doPlayerHorizontalDir(this);
+    else
+      client->doPlayerHorizontalDir(this);
+  }
+  if (this->pending_damage != 0) {
+    // One packet carries at most 127, the rest goes with the next flush
+    int damage = this->pending_damage;
+    if (damage > 127) damage = 127;
+    if (damage < -128) damage = -128;
+    this->pending_damage -= damage;
+    if (host)
+      host->doPlayerTakeDamage(this, (sf::Int8)damage);
+    else
+      client->doPlayerTakeDamage(this, (sf::Int8)damage);
   }
+  this->state_dirty = false;
+  this->direction_dirty = false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
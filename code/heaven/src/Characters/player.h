@@ -42,12 +42,21 @@ class Player : public Character {
   static sf::Texture texture; /**< The texture for this player */
   uint16_t coin_counter = 0;  /**< Counter for collected coins */
   sf::Text name; /**< Name displayed above the player in multiplayer */
+  bool interacting = false; /**< Whether Button::INTERACT_KEY is held, set by
+                            the KeyHandler so replays press buttons too */
 
   std::queue<Collectables::Collectable*>
       to_delete_collectables; /**< Collectables that need to be delted.
                               This is used to allow collectables to play
                               sound after they were collected. */
 
+  // Replication (see flushNetwork())
+  bool state_dirty = false,      /**< State changed since the last flush */
+      direction_dirty = false;   /**< Direction changed since the last flush */
+  State sent_state = State::Idle; /**< State the network got last */
+  int8_t sent_direction = 0;     /**< Direction the network got last */
+  int pending_damage = 0;        /**< Damage taken since the last flush */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -124,6 +133,18 @@ class Player : public Character {
    */
   virtual void heal(uint8_t new_hp);
 
+  /**
+   * @brief Sends the replicated fields that changed since the last flush to
+   * the network, with their final values. Called once per network tick
+   * (Network::NetworkManager::SEND_UPDATE_INTERVAL).
+   *
+   * setState(), setHorizontalMovement() and takeDamage() of a local player
+   * only mark their field dirty, so a value that flips several times (e.g.
+   * by the KeyHandler) is sent at most once, and not at all if it ends up
+   * unchanged. The damage of the flush is summed up.
+   */
+  void flushNetwork();
+
   // ----------------------------------------- //
   /* Getter / Setter */
   // ----------------------------------------- //
@@ -143,6 +164,10 @@ class Player : public Character {
 
   void addCoins(int value);
 
+  void setInteracting(bool value) { this->interacting = value; }
+
+  bool isInteracting() const { return this->interacting; }
+
   // ----------------------------------------- //
   /* Animation Methods */
   // ----------------------------------------- //
@@ -35,9 +35,8 @@ void Shooter::update(float factor) {
   if (nearest)
     if (getDistanceTo(nearest->getPosition()) < this->MAX_SHOOT_DISTANCE) {
       // Check if shoot delay is ok
-      if (this->shoot_clock.getElapsedTime().asMilliseconds() >=
-          this->SHOOT_DELAY) {
-        this->shoot_clock.restart();
+      if (!this->shoot_timer.isRunning()) {
+        this->shoot_timer.start(this->timers, this->SHOOT_DELAY);
         shootAt(nearest);
       }
     }
@@ -108,9 +107,9 @@ void Shooter::toggleAnimation() {
   // Player near
   else if (nearest &&
            getDistanceTo(nearest->getPosition()) <= this->MAX_SHOOT_DISTANCE) {
-    sf::Int32 clock_time = this->shoot_clock.getElapsedTime().asMilliseconds();
-    // Shoot
-    if (clock_time >= this->SHOOT_DELAY - 100 || clock_time < 100) {
+    sf::Int32 remaining = (sf::Int32)this->shoot_timer.getRemaining();
+    // Shoot (100 ms before and after a shot)
+    if (remaining <= 100 || remaining > this->SHOOT_DELAY - 100) {
       // Left
       if (nearest->getPosition().x < getPosition().x) this->last_animation = 3;
       // Right
@@ -36,7 +36,7 @@ class Shooter : public Characters::Enemy {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  protected:
-  sf::Clock shoot_clock; /**< Clock to measure time since last shot */
+  Timer shoot_timer; /**< Runs for SHOOT_DELAY after a shot */
   std::vector<Bullets::Bullet*>
       fired_bullets; /**< All fired (and currently existent) bullets */
 
@@ -62,6 +62,7 @@ class Shooter : public Characters::Enemy {
     if (texture.getSize().x == 0) {
       if (!texture.loadFromFile(this->SPRITE_FILE)) exit(1);
     }
+    Bullets::Bullet::loadTexture();
     setTexture(texture);
     setTextureRect(sf::IntRect(0, 0, 31, 31));
 
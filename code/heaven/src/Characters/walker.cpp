@@ -11,6 +11,8 @@
 
 #include "walker.h"
 
+#include "../job_system.h"
+
 namespace Characters {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -30,13 +32,11 @@ void Walker::update(float factor) {
   Enemy::update(factor);
   for (auto p : this->all_player) {
     if (p->getGlobalBounds().intersects(getGlobalBounds())) {
-      if (this->damage_clocks.count(p) == 0) {
-        this->damage_clocks[p] = sf::Clock();
-        p->takeDamage();
-      } else if (this->damage_clocks[p].getElapsedTime().asMilliseconds() >
-                 500) {
-        this->damage_clocks[p].restart();
-        p->takeDamage();
+      Timer& timer = this->damage_timers[p];
+      if (!timer.isRunning()) {
+        timer.start(this->timers, DAMAGE_INTERVAL);
+        // Players are shared by all enemies updated in parallel
+        JobSystem::defer([p]() { p->takeDamage(); });
       }
     }
   }
@@ -47,13 +47,12 @@ void Walker::update(float factor) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Walker::horizontalMove(float factor) {
   Enemy::horizontalMove(factor);
-  std::vector<Grounds::Ground*> colliding;
   sf::FloatRect new_rect = getHorizontalMove(factor);
   if (new_rect.left < 0)
     setMoveDirRight(0);
-  else if (new_rect.left + new_rect.width > this->window->getSize().x)
+  else if (new_rect.left + new_rect.width > this->size.x)
     setMoveDirLeft(0);
-  else if (canMoveTo(new_rect, this->all_grounds, &colliding, nullptr))
+  else if (canMoveTo(new_rect, this->all_grounds, nullptr, nullptr))
     return;
   else {
     if (this->horizontal_movement > 0)
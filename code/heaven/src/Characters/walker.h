@@ -27,17 +27,19 @@ class Walker : public Characters::Enemy {
       SPRITE_FILE; /**< File with sprites for all walkers */
   static const float HORIZONTAL_MOVE_SPEED; /**< Speed at which this walker can
                                                move horizontally */
+  static const sf::Uint32 DAMAGE_INTERVAL =
+      500; /**< Min time in ms between damage to the same player */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  protected:
   const std::vector<Grounds::Ground*>& all_grounds; /**< Vector with all grounds to check colliding */
-  const sf::RenderWindow* window; /**< Current window */
+  sf::Vector2u size; /**< Size of the world */
   static sf::Texture texture; /**< Texture for this walker */
-  std::map<const Characters::Player*, sf::Clock>
-      damage_clocks; /**< Measures the time passed since last time damage was
-                       dealt to player */
+  std::map<const Characters::Player*, Timer>
+      damage_timers; /**< Run for DAMAGE_INTERVAL after damage was dealt to
+                          a player */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -53,11 +55,13 @@ class Walker : public Characters::Enemy {
    * @param position The new position.
    * @param players A vector to all Players which can take damage by this
    * walker.
+   * @param grounds All grounds to check colliding.
+   * @param size The size of the world.
    */
   Walker(sf::Vector2f position, std::vector<Player*>& players,
          const std::vector<Grounds::Ground*>& grounds,
-         const sf::RenderWindow* window)
-      : Enemy(position, players), all_grounds(grounds), window(window) {
+         const sf::Vector2u& size)
+      : Enemy(position, players), all_grounds(grounds), size(size) {
     if (texture.getSize().x == 0) {
       if (!texture.loadFromFile(this->SPRITE_FILE)) exit(1);
     }
@@ -34,6 +34,8 @@ class Collectable : public sf::Sprite {
  protected:
   bool is_collected =
       false; /**< Determines whether this collectable is collected currently */
+  bool awake = true; /**< Whether the World updates and animates this
+                          collectable (false when far away from all players) */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -100,5 +102,13 @@ class Collectable : public sf::Sprite {
    * @return false Otherwise.
    */
   virtual bool canBeDeleted() = 0;
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  void setAwake(bool awake) { this->awake = awake; }
+
+  bool isAwake() const { return this->awake; }
 };
 }  // namespace Collectables
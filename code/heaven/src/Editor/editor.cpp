@@ -11,6 +11,8 @@
 
 #include "editor.h"
 
+#include "../frame_arena.h"
+
 namespace Editor {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -276,7 +278,7 @@ int Editor::mouseDown(sf::Event& event) {
               this->window->mapPixelToCoords(
                   sf::Vector2i(event.mouseButton.x, event.mouseButton.y)),
               this->world->getPlayers(), this->world->getGrounds(),
-              this->window);
+              this->world->getSize());
           break;
       }
 
@@ -468,7 +470,7 @@ bool Editor::save() {
                         Buyables::Helper::typeToName(
                             ((Grounds::BuyableButton*)ground)->getBuyableType())
                             .c_str());
-    } else if (Grounds::StartButton::getStartGround() == ground) {
+    } else if (this->world->getStartGround() == ground) {
       ele->SetAttribute("start_ground", true);
     }
     g_node->InsertEndChild(ele);
@@ -1101,6 +1103,9 @@ void Editor::testRun(const sf::Vector2f& start_position) {
 
     // Window stuff
     window->display();
+
+    // The world takes its scratch memory from the arena
+    FrameArena::get().reset();
   }
 }
 }  // namespace Editor
\ No newline at end of file
@@ -19,11 +19,11 @@ namespace Grounds {
 std::string Button::name() const { return ButtonHelper::typeToName(getType()); }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-/* contact() */
+/* contactStay() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void Button::contact(Characters::Character* c, float factor) {
+void Button::contactStay(Characters::Character* c, float factor) {
   if (c->getType() == Characters::Type::Player &&
-      sf::Keyboard::isKeyPressed(Button::INTERACT_KEY))
+      ((Characters::Player*)c)->isInteracting())
     doAction((Characters::Player*)c, factor);
 }
 }  // namespace Grounds
\ No newline at end of file
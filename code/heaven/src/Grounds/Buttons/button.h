@@ -31,7 +31,8 @@ class Button : public Ground {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  protected:
-  sf::Clock timeout_clock; /**< Clock to prevent excessive button clicking */
+  Timer timeout; /**< Runs for CLICK_TIMEOUT after a click, to prevent
+                      excessive button clicking */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -47,7 +48,10 @@ class Button : public Ground {
    * @param pos Position of the button
    */
   Button(const sf::Vector2f& pos)
-      : Ground(sf::FloatRect(pos.x, pos.y, 100, 100)) {}
+      : Ground(sf::FloatRect(pos.x, pos.y, 100, 100)) {
+    // The interact key is checked while standing on the button
+    this->stay_events = true;
+  }
 
   // ----------------------------------------- //
   /* Other Methods */
@@ -66,7 +70,14 @@ class Button : public Ground {
     return true;
   };
 
-  virtual void contact(Characters::Character* c, float factor) override;
+  /**
+   * @brief Same as contactStay(), the key can already be pressed.
+   */
+  virtual void contactBegin(Characters::Character* c, float factor) override {
+    contactStay(c, factor);
+  }
+
+  virtual void contactStay(Characters::Character* c, float factor) override;
 
   /**
    * @brief The action to be performed when a player interacts with this button.
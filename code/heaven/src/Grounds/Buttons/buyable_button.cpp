@@ -52,10 +52,10 @@ ButtonType BuyableButton::getType() const { return ButtonType::BuyableButton; }
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void BuyableButton::doAction(Characters::Player* p, float factor) {
   // Return if timeout not reached
-  if (this->timeout_clock.getElapsedTime().asMilliseconds() < CLICK_TIMEOUT)
+  if (this->timeout.isRunning())
     return;
   else
-    this->timeout_clock.restart();
+    this->timeout.start(this->timers, CLICK_TIMEOUT);
 
   if (p->getCoins() >= Buyables::Factory::getPriceOf(this->type)) {
     p->addCoins(-1 * Buyables::Factory::getPriceOf(this->type));
@@ -22,9 +22,6 @@ namespace Grounds {
 const std::string StartButton::TEXTURE_FILE =
     "Ressources/Images/Grounds/Buttons/start_button.png";
 
-Ground* StartButton::start_ground = nullptr;
-World* StartButton::world = nullptr;
-
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* StartButton() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -48,19 +45,17 @@ std::string StartButton::name() const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-/* contact() */
+/* contactStay() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void StartButton::contact(Characters::Character* c, float factor) {
+void StartButton::contactStay(Characters::Character* c, float factor) {
   // Check if
-  // - key pressed
   // - if this is network -> i am host
   // - character is player
   // - character is a local one
-  if (sf::Keyboard::isKeyPressed(Button::INTERACT_KEY) &&
-      ((Network::NetworkManager::getInstance() &&
-        Network::NetworkManager::getInstance()->isHost()) ||
-       !Network::NetworkManager::getInstance()) &&
-      c->getType() == Characters::Type::Player && c->isLocal())
+  // - key pressed
+  if (this->world && (!this->world->getNetwork() || this->world->getHost()) &&
+      c->getType() == Characters::Type::Player && c->isLocal() &&
+      ((Characters::Player*)c)->isInteracting())
     doAction((Characters::Player*)c, factor);
 }
 
@@ -68,42 +63,20 @@ void StartButton::contact(Characters::Character* c, float factor) {
 /* doAction() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void StartButton::doAction(Characters::Player* p, float factor) {
-  if (!this->start_ground)
+  if (!this->world) return;
+  Ground* start_ground = this->world->getStartGround();
+  if (!start_ground)
     return;  // Do nothing if ground isn't set or already removed
 
-  this->world->removeGround(StartButton::start_ground);
+  this->world->removeGround(start_ground);
 
-  if (Network::NetworkManager::getInstance() &&
-      Network::NetworkManager::getInstance()->isHost()) {
-    ((Network::Host*)Network::NetworkManager::getInstance())
-        ->doRemoveGround(StartButton::start_ground);
-  }
+  if (this->world->getHost())
+    this->world->getHost()->doRemoveGround(start_ground);
 
   this->world->startRace();
 
-  StartButton::start_ground = nullptr;
-
 #ifdef INFO
   std::cout << "Info: StartButton::doAction -> done." << std::endl;
 #endif
 }
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/* setStartGround() */
-///////////////////////////////////////////////////////////////////////////////////////////////////
-void StartButton::setStartGround(World* world, Ground* start_ground) {
-  if (!world || !start_ground) return;
-  StartButton::world = world;
-  StartButton::start_ground = start_ground;
-#ifdef INFO
-  std::cout
-      << "Info: StartButton::setStartGround -> world and start_ground were set."
-      << std::endl;
-#endif
-}
-
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/* getStartGround() */
-///////////////////////////////////////////////////////////////////////////////////////////////////
-Ground* StartButton::getStartGround() { return StartButton::start_ground; }
 }  // namespace Grounds
\ No newline at end of file
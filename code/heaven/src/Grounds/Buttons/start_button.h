@@ -31,10 +31,8 @@ class StartButton : public Button {
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  private:
-  sf::Texture texture; /**< Texture */
-
-  static Ground* start_ground; /**< The ground being controlled */
-  static World* world;         /**< The world which manages the start ground */
+  sf::Texture texture;    /**< Texture */
+  World* world = nullptr; /**< The world with the start ground */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -59,7 +57,8 @@ class StartButton : public Button {
 
   std::string name() const override;
 
-  virtual void contact(Characters::Character* c, float factor) override;
+  virtual void contactStay(Characters::Character* c,
+                           float factor) override;
 
   void doAction(Characters::Player* p, float factor) override;
 
@@ -68,18 +67,10 @@ class StartButton : public Button {
   // ----------------------------------------- //
 
   /**
-   * @brief Sets the ground which is controlled by the start button.
+   * @brief Sets the world whose start ground is removed by this button.
    *
-   * @param world A pointer to the world containing the start ground
-   * @param start_ground The ground that needs to be removed to start the game.
-   */
-  static void setStartGround(World* world, Ground* start_ground);
-
-  /**
-   * @brief Gets the start_ground.
-   * 
-   * @return Ground* The start_ground
+   * @param world The world.
    */
-  static Ground* getStartGround();
+  void setWorld(World* world) { this->world = world; }
 };
 }  // namespace Grounds
\ No newline at end of file
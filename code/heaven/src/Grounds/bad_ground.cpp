@@ -27,16 +27,14 @@ bool BadGround::canCollide(const Characters::Character* c) const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-/* contact() */
+/* contactStay() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void BadGround::contact(Characters::Character* c, float factor) {
+void BadGround::contactStay(Characters::Character* c, float factor) {
   if (c->getType() == Characters::Type::Player && c->getHP() > 0) {
     c->canKeepJumping(false);
-    if (this->damage_clock.count(c) == 0) {
-      this->damage_clock[c] = sf::Clock();
-      c->takeDamage();
-    } else if (this->damage_clock[c].getElapsedTime().asMilliseconds() > 500) {
-      this->damage_clock[c].restart();
+    Timer& timer = this->damage_timers[c];
+    if (!timer.isRunning()) {
+      timer.start(this->timers, DAMAGE_INTERVAL);
       c->takeDamage();
     }
   }
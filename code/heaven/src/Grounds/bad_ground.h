@@ -27,15 +27,17 @@ class BadGround : public Ground {
   static sf::Texture base_texture; /**< Texture for all bad grounds */
   static const int
       DAMAGE; /**< The damage dealt to Characters on contact */
+  static const sf::Uint32 DAMAGE_INTERVAL =
+      500; /**< Min time in ms between damage to the same Character */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  protected:
 
-  std::map<const Characters::Character*, sf::Clock>
-      damage_clock; /**< Measures the time passed since last time damage was
-                       dealt to player */
+  std::map<const Characters::Character*, Timer>
+      damage_timers; /**< Run for DAMAGE_INTERVAL after damage was dealt to
+                          a Character */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -52,6 +54,7 @@ class BadGround : public Ground {
    * @param rect Position and size.
    */
   BadGround(const sf::FloatRect& rect) : Ground(rect) {
+    this->stay_events = true;  // Damage while standing in it
     if (this->base_texture.getSize().x == 0) {
       // Only load once to static
       if (!this->base_texture.loadFromFile(
@@ -80,6 +83,13 @@ class BadGround : public Ground {
 
   virtual bool canCollide(const Characters::Character* c) const override;
 
-  virtual void contact(Characters::Character* c, float factor) override;
+  /**
+   * @brief Same as contactStay().
+   */
+  virtual void contactBegin(Characters::Character* c, float factor) override {
+    contactStay(c, factor);
+  }
+
+  virtual void contactStay(Characters::Character* c, float factor) override;
 };
 }  // namespace Grounds
\ No newline at end of file
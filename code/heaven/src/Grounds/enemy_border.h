@@ -57,8 +57,6 @@ class EnemyBorder : public Ground {
 
   std::string name() const override { return "enemy_border"; }
 
-  virtual void contact(Characters::Character* c, float factor){};
-
   virtual bool canCollide(const Characters::Character* c) const override {
     return c->getType() == Characters::Type::Player;
   }
@@ -15,6 +15,7 @@
 
 #include "../Characters/character.h"
 #include "../main_helper.h"
+#include "../timer_wheel.h"
 
 /**
  * @brief Namespace for all grounds.
@@ -38,6 +39,11 @@ class Ground {
 
   sf::FloatRect global_bounds; /**< Global bounds of this ground */
 
+  bool stay_events = false; /**< Whether contactStay() is called, only set
+                                 by grounds that need it */
+
+  TimerWheel* timers = nullptr; /**< Timers of the World of this ground */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -78,13 +84,31 @@ class Ground {
    */
   virtual void draw(sf::RenderWindow* window) const;
 
-  /** @fn contact
-   * Should be called when a Character collides with this Ground.
+  /**
+   * @brief Called by the World in the tick a Character starts to collide
+   * with this Ground.
    *
    * @param c The Character which collided.
    * @param factor The time factor.
    */
-  virtual void contact(Characters::Character* c, float factor) = 0;
+  virtual void contactBegin(Characters::Character* c, float factor) {}
+
+  /**
+   * @brief Called by the World in every following tick the Character still
+   * collides with this Ground. Only if stay_events is set.
+   *
+   * @param c The Character which collides.
+   * @param factor The time factor.
+   */
+  virtual void contactStay(Characters::Character* c, float factor) {}
+
+  /**
+   * @brief Called by the World in the tick a Character stopped colliding
+   * with this Ground. Not called if one of both was removed from the World.
+   *
+   * @param c The Character which collided.
+   */
+  virtual void contactEnd(Characters::Character* c) {}
 
   /**
    * @brief Returns whether the given Character can pass through this ground.
@@ -123,5 +147,14 @@ class Ground {
 
   virtual std::vector<sf::Sprite*>& getSprites() { return this->sprites; 
   }
+
+  bool hasStayEvents() const { return this->stay_events; }
+
+  /**
+   * @brief Sets the timers to use, set when added to a World.
+   *
+   * @param timers The timers of the World.
+   */
+  void setTimers(TimerWheel* timers) { this->timers = timers; }
 };
 }  // namespace Grounds
\ No newline at end of file
@@ -22,18 +22,14 @@ sf::Texture Portal::base_texture;
 sf::SoundBuffer Portal::sound_buffer;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-/* contact() */
+/* contactBegin() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void Portal::contact(Characters::Character* c, float factor) {
-  sf::Int32 time = this->timeout_clock.getElapsedTime().asMilliseconds();
-  if (time < 100) return;  // If less than 100 ms since last contact -> skip
-
-  this->timeout_clock.restart();
+void Portal::contactBegin(Characters::Character* c, float factor) {
   c->setFixedMove(sf::Vector2f(global_bounds.left, global_bounds.top) -
                   c->getPosition() + this->destination);
   this->sound.play();
 #ifdef PORTAL_DEBUG
-  std::cout << "Portal Debug: Portal::contact() was called!" << std::endl;
+  std::cout << "Portal Debug: Portal::contactBegin() was called!" << std::endl;
 #endif
 }
 
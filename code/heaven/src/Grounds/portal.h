@@ -39,9 +39,6 @@ class Portal : public Ground {
                                editor and debugging) */
   sf::Vertex dest_line[2];  /**< Line to show destination in editor */
 
-  sf::Clock timeout_clock; /**< Clock for timeout between multiple contacts with
-                              the portal */
-
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -90,7 +87,14 @@ class Portal : public Ground {
 
   std::string name() const override { return "portal"; }
 
-  void contact(Characters::Character* c, float factor);
+  /**
+   * @brief Teleports the Character. It has to leave the portal before it is
+   * teleported again.
+   *
+   * @param c The Character.
+   * @param factor The time factor.
+   */
+  void contactBegin(Characters::Character* c, float factor) override;
 
   bool canCollide(const Characters::Character* c) const override {
     return true;
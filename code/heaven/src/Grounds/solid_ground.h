@@ -71,14 +71,6 @@ class SolidGround : public Ground {
   /* Other Methods */
   // ----------------------------------------- //
 
-  /**
-   * @brief Method to run when contacting with Character.
-   *
-   * @param c Pointer to the Character
-   * @param factor The time factor.
-   */
-  void contact(Characters::Character* c, float factor) {}
-
   /**
    * @brief Returns the name of this sub class.
    *
@@ -17,29 +17,32 @@ namespace Network {
 /* update() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::update() {
-  if (this->player_ids.size() > 0) {
-    if (this->update_clock.getElapsedTime().asMilliseconds() >=
-        SEND_UPDATE_INTERVAL) {
-      this->update_clock.restart();
-      // Update position
-      sf::Packet* position_packet =
-          playerSetPosPacket(getPlayerId(this->world->getPlayer(0)),
-                             this->world->getPlayer(0)->getPosition());
-      this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-          this->tcp_socket, position_packet));
-    }
+  // Ping after being accepted, id is needed by host to answer
+  if (!this->player_ids.empty() && pingDue()) {
+    sf::Packet* packet = pingPacket(
+        getPlayerId(this->world->getPlayer(0)),
+        (sf::Uint32)this->stats_clock.getElapsedTime().asMilliseconds());
+    this->send_tcp_packets.push(
+        std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, packet));
   }
 
-  while (!this->send_tcp_packets.empty()) {
-    auto pair = this->send_tcp_packets.front();
-    sendTcpPacket(pair.first, pair.second);
-    delete pair.second;
-    this->send_tcp_packets.pop();
+  // Changes of the main player since the last network tick, final values
+  // only (id is needed, kept dirty until accepted)
+  if (!this->player_ids.empty() &&
+      this->update_clock.getElapsedTime().asMilliseconds() >=
+          SEND_UPDATE_INTERVAL) {
+    this->update_clock.restart();
+    for (auto player : this->world->getPlayers()) player->flushNetwork();
   }
+
+  // Position of main player is simulated by host from inputs (see predict())
+  sendQueuedTcp();
   receiveTcp();
   // sendUdp();
   // receiveUdp();
   handleReceived();
+  interpolate();
+  updateStats();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -94,6 +97,44 @@ bool Client::start(sf::IpAddress host) {
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* predict() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float Client::predict(float factor) {
+  Characters::Player* player = this->world->getPlayer(0);
+  float vertical_movement = this->correction;
+  this->correction = 0;
+
+  this->prediction_time += factor;
+  if (this->prediction_time > MAX_STEPS_PER_UPDATE * INPUT_STEP)
+    this->prediction_time = MAX_STEPS_PER_UPDATE * INPUT_STEP;
+
+  while (this->prediction_time >= INPUT_STEP) {
+    this->prediction_time -= INPUT_STEP;
+
+    PredictedInput input;
+    input.dir = player->getDirection();
+    input.jump = player->keepsJumping();
+    vertical_movement += this->world->simulateCharacter(player, INPUT_STEP);
+
+    // Not accepted by host yet
+    if (this->player_ids.size() == 0) continue;
+
+    input.sequence = ++this->input_sequence;
+    input.predicted = player->getMoveState();
+    this->pending_inputs.push_back(input);
+    if (this->pending_inputs.size() > MAX_PENDING_INPUTS)
+      this->pending_inputs.pop_front();
+
+    sf::Packet* packet = playerInputPacket(getPlayerId(player), input.sequence,
+                                           input.dir, input.jump);
+    this->send_tcp_packets.push(
+        std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, packet));
+  }
+
+  return vertical_movement;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* doAddPlayer() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -107,7 +148,8 @@ void Client::doWantAddPlayer(Characters::Player* p) {
 /* doPlayerChangeState() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::doPlayerChangeState(const Characters::Player* p) {
-  uint8_t id = getPlayerId(p);
+  if (this->replaying) return;  // Already sent
+  uint16_t id = getPlayerId(p);
   sf::Packet* packet = playerChangeStatePacket(id, p->getState());
   this->send_tcp_packets.push(
       std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, packet));
@@ -117,7 +159,8 @@ void Client::doPlayerChangeState(const Characters::Player* p) {
 /* doPlayerHorizontalDir() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::doPlayerHorizontalDir(const Characters::Player* p) {
-  uint8_t id = getPlayerId(p);
+  if (this->replaying) return;  // Already sent
+  uint16_t id = getPlayerId(p);
   sf::Int8 dir = p->getDirection();
   sf::Packet* packet = playerHorizontalDirPacket(id, dir);
   this->send_tcp_packets.push(
@@ -128,7 +171,7 @@ void Client::doPlayerHorizontalDir(const Characters::Player* p) {
 /* doPlayerTakeDamage() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::doPlayerTakeDamage(const Characters::Player* p, sf::Int8 damage) {
-  uint8_t id = getPlayerId(p);
+  uint16_t id = getPlayerId(p);
   sf::Packet* packet = playerTakeDamagePacket(id, damage);
   this->send_tcp_packets.push(
       std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, packet));
@@ -138,7 +181,7 @@ void Client::doPlayerTakeDamage(const Characters::Player* p, sf::Int8 damage) {
 /* doPlayerHeal() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////2
 void Client::doPlayerHeal(const Characters::Player* p, sf::Uint8 new_hp) {
-  sf::Uint8 id = getPlayerId(p);
+  sf::Uint16 id = getPlayerId(p);
   sf::Packet* packet = playerHealPacket(id, new_hp);
   this->send_tcp_packets.push(
       std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, packet));
@@ -225,18 +268,18 @@ void Client::doPlayerHeal(const Characters::Player* p, sf::Uint8 new_hp) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::receiveTcp() {
   // Receive tcp packets
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   while (true) {
     sf::Socket::Status status = this->tcp_socket->receive(*packet);
     switch (status) {
       case sf::Socket::Status::Done:
-        this->receive_tcp_packets.push(packet);
-        packet = new sf::Packet();
+        pushReceivedTcp(0, packet);
+        packet = this->packet_pool.acquire();
         continue;
         break;
 
       case sf::Socket::Status::Partial:
-        continue;
+        // Rest is received next time
         break;
 
       case sf::Socket::Status::Disconnected:
@@ -255,7 +298,24 @@ void Client::receiveTcp() {
     }
     break;
   }
-  delete packet;
+  this->packet_pool.release(packet);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* interpolate() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::interpolate() {
+  sf::Int32 now = this->snapshot_clock.getElapsedTime().asMilliseconds();
+  for (auto& player : this->player_snapshots) {
+    if (player.second.empty() || this->player_ids.count(player.first) == 0)
+      continue;
+    getPlayer(player.first)->setPosition(player.second.sample(now));
+  }
+  for (auto& enemy : this->enemy_snapshots) {
+    if (enemy.second.empty() || this->enemy_ids.count(enemy.first) == 0)
+      continue;
+    getEnemy(enemy.first)->setPosition(enemy.second.sample(now));
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -270,7 +330,7 @@ void Client::handleWantAddPlayer(sf::Packet* packet) {
 /* handleAddPlayer() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handleAddPlayer(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int64 x, y;
   *packet >> x;
@@ -292,29 +352,37 @@ void Client::handleAddPlayer(sf::Packet* packet) {
 /* handleAcceptAddPlayer() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handleAcceptAddPlayer(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
+  sf::Int64 x, y;
+  *packet >> x;
+  *packet >> y;
   this->player_ids[id] = this->world->getPlayer(0);
   this->player_ids[id]->setName(std::to_string(id));
+  // Differs from the start position when joining a running game
+  this->player_ids[id]->setPosition((float)x, (float)y);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* handlePlayerSetPos() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handlePlayerSetPos(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int64 x, y;
   *packet >> x;
   *packet >> y;
-  getPlayer(id)->setPosition((float)x, (float)y);
+  // Applied in interpolate()
+  this->player_snapshots[id].push(
+      this->snapshot_clock.getElapsedTime().asMilliseconds(),
+      sf::Vector2f((float)x, (float)y));
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* handlePlayerChangeState() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handlePlayerChangeState(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Uint8 state;
   *packet >> state;
@@ -325,7 +393,7 @@ void Client::handlePlayerChangeState(sf::Packet* packet) {
 /* handlePlayerHorizontalDir() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handlePlayerHorizontalDir(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int8 dir;
   *packet >> dir;
@@ -341,7 +409,7 @@ void Client::handlePlayerHorizontalDir(sf::Packet* packet) {
 /* handlePlayerTakeDamage() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handlePlayerTakeDamage(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int8 damage;
   *packet >> damage;
@@ -352,7 +420,7 @@ void Client::handlePlayerTakeDamage(sf::Packet* packet) {
 /* handlePlayerHeal() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handlePlayerHeal(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Uint8 new_hp;
   *packet >> new_hp;
@@ -416,6 +484,7 @@ void Client::handleGroundSetPos(sf::Packet* packet) {
   sf::Vector2f pos((float)x, (float)y);
   Grounds::Ground* g = getGround(id);
   g->setPosition(pos);
+  this->world->groundMoved();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -462,7 +531,10 @@ void Client::handleEnemySetPos(sf::Packet* packet) {
   sf::Int64 x, y;
   *packet >> x;
   *packet >> y;
-  getEnemy((size_t)id)->setPosition((float)x, (float)y);
+  // Applied in interpolate()
+  this->enemy_snapshots[(size_t)id].push(
+      this->snapshot_clock.getElapsedTime().asMilliseconds(),
+      sf::Vector2f((float)x, (float)y));
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -505,6 +577,7 @@ void Client::handleRemoveEnemy(sf::Packet* packet) {
   Characters::Enemy* enemy = getEnemy(id);
   this->world->removeEnemy(enemy);
   this->enemy_ids.erase(id);
+  this->enemy_snapshots.erase(id);
   delete enemy;
 }
 
@@ -532,7 +605,7 @@ void Client::handleAddCollectable(sf::Packet* packet) {
 void Client::handleCollectableCollected(sf::Packet* packet) {
   sf::Uint32 collectable_id;
   *packet >> collectable_id;
-  sf::Uint8 player_id;
+  sf::Uint16 player_id;
   *packet >> player_id;
   if (this->getPlayer(player_id)->collect(getCollectable(collectable_id)))
     this->world->removeCollectable(getCollectable(collectable_id));
@@ -556,19 +629,157 @@ void Client::handleRemoveCollectable(sf::Packet* packet) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handleSetupRace(sf::Packet* packet) {
   sf::Uint16 distance;
+  sf::Uint8 started;
+  sf::Uint32 time;
   *packet >> distance;
+  *packet >> started;
+  *packet >> time;
   this->world->setRaceDistance(distance);
+  if (started) this->world->startRace((sf::Int32)time);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* handleDeclareWinner() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Client::handleDeclareWinner(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   sf::Uint32 time;
   *packet >> id;
   *packet >> time;
 
   showPlayerWon(id, time);
 }
-}  // namespace Network
\ No newline at end of file
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePlayerInput() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::handlePlayerInput(sf::Packet* packet) {
+  std::cerr << "Error while handling received packet: PlayerInput must "
+            << "not be sent to a client!" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePlayerAck() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::handlePlayerAck(sf::Packet* packet) {
+  sf::Uint32 sequence;
+  *packet >> sequence;
+  Characters::Character::MoveState state;
+  *packet >> state.position.x;
+  *packet >> state.position.y;
+  *packet >> state.vertical_speed;
+  *packet >> state.jump_time;
+  sf::Int8 dir;
+  *packet >> dir;
+  state.horizontal_movement = dir;
+  sf::Uint8 flags;
+  *packet >> flags;
+  state.on_ground = flags & 1;
+  state.keeps_jumping = flags & 2;
+  state.can_keep_jumping = flags & 4;
+
+  // Drop acknowledged inputs
+  bool found = false;
+  sf::Vector2f predicted;
+  while (!this->pending_inputs.empty() &&
+         this->pending_inputs.front().sequence <= sequence) {
+    if (this->pending_inputs.front().sequence == sequence) {
+      found = true;
+      predicted = this->pending_inputs.front().predicted.position;
+    }
+    this->pending_inputs.pop_front();
+  }
+
+  if (found) {
+    sf::Vector2f diff = predicted - state.position;
+    if (sqrt(diff.x * diff.x + diff.y * diff.y) <= RECONCILE_TOLERANCE) return;
+  }
+
+  // Rewind to state of host and replay pending inputs
+  Characters::Player* player = this->world->getPlayer(0);
+  float old_y = player->getPosition().y;
+  sf::Int8 current_dir = player->getDirection();
+  bool current_jump = player->keepsJumping();
+
+  this->replaying = true;
+  player->setMoveState(state);
+  for (auto& input : this->pending_inputs) {
+    applyPlayerInput(player, input.dir, input.jump);
+    this->world->simulateCharacter(player, INPUT_STEP);
+    input.predicted = player->getMoveState();
+  }
+  applyPlayerInput(player, current_dir, current_jump);
+  this->replaying = false;
+
+  this->correction += old_y - player->getPosition().y;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handleWorldState() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::handleWorldState(sf::Packet* packet) {
+  // Grounds first, others may stand on them
+  if (!handleWorldStateSection(packet) || !handleWorldStateSection(packet))
+    std::cerr << "Error while handling received packet: WorldState is "
+              << "corrupted!" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handleWorldStateSection() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Client::handleWorldStateSection(sf::Packet* packet) {
+  sf::Uint32 raw_size, size;
+  *packet >> raw_size;
+  *packet >> size;
+  std::vector<uint8_t> compressed(size);
+  for (sf::Uint32 i = 0; i < size && *packet; i++) *packet >> compressed[i];
+  if (!*packet) return false;
+
+  std::vector<uint8_t> data;
+  if (!Compression::decompress(compressed.data(), compressed.size(), &data,
+                               raw_size))
+    return false;
+
+  // Each packet is its size(Uint32) followed by its data
+  size_t pos = 0;
+  while (pos + 4 <= data.size()) {
+    sf::Uint32 packet_size = (sf::Uint32)data[pos] << 24 |
+                             (sf::Uint32)data[pos + 1] << 16 |
+                             (sf::Uint32)data[pos + 2] << 8 | data[pos + 3];
+    pos += 4;
+    if (packet_size > data.size() - pos) return false;
+
+    sf::Packet* inner = this->packet_pool.acquire();
+    inner->append(data.data() + pos, packet_size);
+    handlePacket(inner);
+    this->packet_pool.release(inner);
+    pos += packet_size;
+  }
+  return pos == data.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePing() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::handlePing(sf::Packet* packet) {
+  sf::Uint16 id;
+  sf::Uint32 time;
+  *packet >> id;
+  *packet >> time;
+  sf::Packet* pong_packet = pongPacket(id, time);
+  this->send_tcp_packets.push(
+      std::pair<sf::TcpSocket*, sf::Packet*>(this->tcp_socket, pong_packet));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePong() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Client::handlePong(sf::Packet* packet) {
+  sf::Uint16 id;
+  sf::Uint32 time;
+  *packet >> id;
+  *packet >> time;
+  this->stats[0].addRtt(this->stats_clock.getElapsedTime().asMilliseconds() -
+                        (sf::Int32)time);
+}
+}  // namespace Network
@@ -11,13 +11,41 @@
 
 #pragma once
 
+#include <deque>
+
 #include "network_manager.h"
+#include "snapshot_buffer.h"
 
 namespace Network {
 /** \class Client
  *  @brief NetworkManager as client.
  */
 class Client : public NetworkManager {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t MAX_PENDING_INPUTS =
+      256; /**< Max inputs waiting for acknowledgement by the host */
+
+  static const uint8_t MAX_STEPS_PER_UPDATE =
+      10; /**< Max prediction steps simulated in one update */
+
+  static constexpr float RECONCILE_TOLERANCE =
+      1.f; /**< Max distance between predicted and acknowledged position
+           before the prediction gets corrected */
+
+  /**
+   * @brief An input of the main player with the state predicted after
+   * applying it.
+   */
+  struct PredictedInput {
+    sf::Uint32 sequence;                        /**< Sequence number */
+    sf::Int8 dir;                               /**< Horizontal direction */
+    bool jump;                                  /**< Whether jump is pressed */
+    Characters::Character::MoveState predicted; /**< State after the step */
+  };
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +61,21 @@ class Client : public NetworkManager {
   Characters::Factory* character_factory;     /**< Factory for characters */
   Collectables::Factory* collectable_factory; /**< Factory for collectables */
 
+  sf::Clock snapshot_clock; /**< Clock for timestamps of received positions */
+  std::map<uint16_t, SnapshotBuffer>
+      player_snapshots; /**< Key: id of remote player;
+                        val: received positions */
+  std::map<size_t, SnapshotBuffer>
+      enemy_snapshots; /**< Key: id of enemy; val: received positions */
+
+  std::deque<PredictedInput>
+      pending_inputs;            /**< Inputs not yet acknowledged by host */
+  sf::Uint32 input_sequence = 0; /**< Sequence number of the last input */
+  float prediction_time = 0,     /**< Time factor not yet simulated */
+      correction = 0; /**< Vertical movement of main player by corrections
+                      since the last prediction */
+  bool replaying = false; /**< Whether inputs are currently replayed */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +120,8 @@ class Client : public NetworkManager {
 
   bool isHost() const override { return false; }
 
+  Client* asClient() override { return this; }
+
   void update() override;
 
   /**
@@ -89,6 +134,19 @@ class Client : public NetworkManager {
    */
   bool start(sf::IpAddress host);
 
+  /**
+   * @brief Moves the main player in fixed steps of INPUT_STEP and sends the
+   * input of every step to the host.
+   *
+   * Called by the world instead of moving the main player itself. The host
+   * simulates the same steps and acknowledges the resulting state, see
+   * handlePlayerAck().
+   *
+   * @param factor The time factor of this frame.
+   * @return float The vertical movement of the main player.
+   */
+  float predict(float factor);
+
   // ----------------------------------------- //
   /* From World Methods */
   // ----------------------------------------- //
@@ -113,6 +171,23 @@ class Client : public NetworkManager {
 
   void receiveTcp();
 
+  /**
+   * @brief Sets the positions of all remote players and enemies from their
+   * snapshot buffers.
+   *
+   */
+  void interpolate();
+
+  /**
+   * @brief Reads and decompresses one section of a WorldState packet and
+   * handles every packet inside.
+   *
+   * @param packet The WorldState packet.
+   * @return true On success.
+   * @return false If the section is corrupted.
+   */
+  bool handleWorldStateSection(sf::Packet* packet);
+
   // ----------------------------------------- //
   /* Received Packet Handling */
   // ----------------------------------------- //
@@ -160,5 +235,24 @@ class Client : public NetworkManager {
   virtual void handleSetupRace(sf::Packet* packet) override;
 
   virtual void handleDeclareWinner(sf::Packet* packet) override;
+
+  virtual void handlePlayerInput(sf::Packet* packet) override;
+
+  /**
+   * @brief Reconciles the prediction with the state of the host.
+   *
+   * All acknowledged inputs are dropped. If the predicted state differs from
+   * the host's, the main player is rewound to the host's state and all
+   * pending inputs are replayed.
+   *
+   * @param packet The received packet.
+   */
+  virtual void handlePlayerAck(sf::Packet* packet) override;
+
+  virtual void handleWorldState(sf::Packet* packet) override;
+
+  virtual void handlePing(sf::Packet* packet) override;
+
+  virtual void handlePong(sf::Packet* packet) override;
 };
 }  // namespace Network
\ No newline at end of file
@@ -0,0 +1,117 @@
+/**
+ * @file compression.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for Compression class.
+ * @version 0.1
+ * @date 2020-02-08
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "compression.h"
+
+#include <string.h>
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* compress() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<uint8_t> Compression::compress(const void* data, size_t size) {
+  const uint8_t* in = (const uint8_t*)data;
+  std::vector<uint8_t> out;
+  out.reserve(size / 2 + 16);
+
+  // Last position of each hashed 4 byte sequence (+1, 0 means none)
+  std::vector<size_t> table((size_t)1 << HASH_BITS, 0);
+
+  size_t literals = 0, pos = 0;
+  auto flushLiterals = [&]() {
+    size_t start = pos - literals;
+    while (literals > 0) {
+      size_t count = literals < MAX_LITERALS ? literals : MAX_LITERALS;
+      out.push_back((uint8_t)(count - 1));
+      out.insert(out.end(), in + start, in + start + count);
+      start += count;
+      literals -= count;
+    }
+  };
+  auto hash = [&](size_t i) {
+    uint32_t value;
+    memcpy(&value, in + i, sizeof(value));
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+  };
+
+  while (pos < size) {
+    size_t length = 0, offset = 0;
+    if (pos + MIN_MATCH <= size) {
+      uint32_t h = hash(pos);
+      size_t candidate = table[h];
+      table[h] = pos + 1;
+      if (candidate > 0 && pos - (candidate - 1) <= MAX_OFFSET) {
+        size_t start = candidate - 1;
+        while (pos + length < size && length < MAX_MATCH &&
+               in[start + length] == in[pos + length])
+          length++;
+        offset = pos - start;
+      }
+    }
+
+    if (length < MIN_MATCH) {
+      pos++;
+      literals++;
+      continue;
+    }
+
+    flushLiterals();
+    out.push_back((uint8_t)(128 + length - MIN_MATCH));
+    out.push_back((uint8_t)(offset >> 8));
+    out.push_back((uint8_t)(offset & 0xFF));
+    // Remember skipped positions for later matches
+    for (size_t i = pos + 1; i < pos + length && i + MIN_MATCH <= size; i++)
+      table[hash(i)] = i + 1;
+    pos += length;
+  }
+  flushLiterals();
+
+  return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* decompress() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Compression::decompress(const void* data, size_t size,
+                             std::vector<uint8_t>* out, size_t out_size) {
+  const uint8_t* in = (const uint8_t*)data;
+  out->clear();
+  // A match block of 3 bytes is the biggest expansion, so a corrupted
+  // out_size can't make us reserve more than the data could ever produce
+  if (out_size > size / 3 * MAX_MATCH + size % 3) return false;
+  out->reserve(out_size);
+
+  size_t pos = 0;
+  while (pos < size) {
+    uint8_t control = in[pos++];
+    if (control < 128) {
+      size_t count = (size_t)control + 1;
+      if (pos + count > size || out->size() + count > out_size) return false;
+      out->insert(out->end(), in + pos, in + pos + count);
+      pos += count;
+    } else {
+      size_t length = (size_t)control - 128 + MIN_MATCH;
+      if (pos + 2 > size) return false;
+      size_t offset = (size_t)in[pos] << 8 | in[pos + 1];
+      pos += 2;
+      if (offset == 0 || offset > out->size() ||
+          out->size() + length > out_size)
+        return false;
+      // Byte by byte, match may overlap with itself
+      size_t start = out->size() - offset;
+      for (size_t i = 0; i < length; i++) out->push_back((*out)[start + i]);
+    }
+  }
+
+  return out->size() == out_size;
+}
+}  // namespace Network
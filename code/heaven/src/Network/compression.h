@@ -0,0 +1,66 @@
+/**
+ * @file compression.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for Compression class.
+ * @version 0.1
+ * @date 2020-02-08
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace Network {
+/** \class Compression
+ *  @brief Simple LZ77 compression for bigger blobs sent over the network.
+ *
+ * The compressed data is a sequence of blocks, each starting with a control
+ * byte c:
+ *  - c < 128: c + 1 literal bytes are following.
+ *  - c >= 128: A match of c - 128 + MIN_MATCH bytes, starting offset(Uint16,
+ *    big endian) bytes before the current end of the output.
+ */
+class Compression {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t MIN_MATCH = 4,     /**< Min length of a match */
+      MAX_MATCH = 127 + MIN_MATCH,       /**< Max length of a match */
+      MAX_LITERALS = 128,                /**< Max literals in one block */
+      MAX_OFFSET = 0xFFFF,               /**< Max distance of a match */
+      HASH_BITS = 12;                    /**< Size of the hash table */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /**
+   * @brief Compresses data.
+   *
+   * @param data The data to compress.
+   * @param size Size of the data in bytes.
+   * @return std::vector<uint8_t> The compressed data.
+   */
+  static std::vector<uint8_t> compress(const void* data, size_t size);
+
+  /**
+   * @brief Decompresses data compressed by compress().
+   *
+   * @param data The compressed data.
+   * @param size Size of the compressed data in bytes.
+   * @param out Output for the decompressed data.
+   * @param out_size Expected size of the decompressed data.
+   * @return true On success.
+   * @return false If the data is corrupted or can't expand to out_size.
+   */
+  static bool decompress(const void* data, size_t size,
+                         std::vector<uint8_t>* out, size_t out_size);
+};
+}  // namespace Network
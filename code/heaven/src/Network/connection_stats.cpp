@@ -0,0 +1,95 @@
+/**
+ * @file connection_stats.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for ConnectionStats class.
+ * @version 0.1
+ * @date 2020-02-10
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "connection_stats.h"
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* countSent() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::countSent(const sf::Packet& packet) {
+  count(packet, &this->sent, &this->sent_total);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* countReceived() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::countReceived(const sf::Packet& packet) {
+  count(packet, &this->received, &this->received_total);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* addRtt() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::addRtt(sf::Int32 rtt) {
+  if (this->rtt < 0) {
+    this->rtt = (float)rtt;
+    this->rtt_deviation = (float)rtt / 2.f;
+    return;
+  }
+  // Like tcp rtt estimation
+  float deviation = (float)rtt - this->rtt;
+  this->rtt_deviation +=
+      ((deviation < 0 ? -deviation : deviation) - this->rtt_deviation) / 4.f;
+  this->rtt += deviation / 8.f;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setQueue() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::setQueue(size_t bytes, size_t packets) {
+  this->queue_bytes = bytes;
+  this->queue_packets = packets;
+  if (bytes > this->max_queue_bytes) this->max_queue_bytes = bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* update() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::update(sf::Int64 now) {
+  sf::Int64 passed = now - this->rate_start;
+  if (passed < RATE_INTERVAL) return;
+
+  this->sent_rate.packets =
+      (this->sent_total.packets - this->sent_before.packets) * 1000 / passed;
+  this->sent_rate.bytes =
+      (this->sent_total.bytes - this->sent_before.bytes) * 1000 / passed;
+  this->received_rate.packets =
+      (this->received_total.packets - this->received_before.packets) * 1000 /
+      passed;
+  this->received_rate.bytes =
+      (this->received_total.bytes - this->received_before.bytes) * 1000 /
+      passed;
+
+  this->sent_before = this->sent_total;
+  this->received_before = this->received_total;
+  this->rate_start = now;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* count() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ConnectionStats::count(const sf::Packet& packet,
+                            std::map<sf::Uint8, Counter>* counters,
+                            Counter* total) {
+  if (packet.getDataSize() == 0) return;
+  sf::Uint8 type = *(const sf::Uint8*)packet.getData();
+  // Size is sent as Uint32 in front of the data
+  sf::Uint64 bytes = packet.getDataSize() + sizeof(sf::Uint32);
+
+  Counter& counter = (*counters)[type];
+  counter.packets++;
+  counter.bytes += bytes;
+  total->packets++;
+  total->bytes += bytes;
+}
+}  // namespace Network
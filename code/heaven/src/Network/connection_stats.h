@@ -0,0 +1,157 @@
+/**
+ * @file connection_stats.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for ConnectionStats class.
+ * @version 0.1
+ * @date 2020-02-10
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <map>
+
+namespace Network {
+/** \class ConnectionStats
+ *  @brief Counts the traffic of one connection.
+ *
+ * Packets and bytes are counted by PacketType (first byte of a packet). The
+ * bytes include the size sf::Packet sends in front of the data. Rates are
+ * calculated over the last RATE_INTERVAL.
+ */
+class ConnectionStats {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const sf::Int32 RATE_INTERVAL =
+      1000; /**< Time in ms rates are calculated over */
+
+  /**
+   * @brief Number of packets and bytes.
+   */
+  struct Counter {
+    sf::Uint64 packets = 0, /**< Number of packets */
+        bytes = 0;          /**< Number of bytes */
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  std::map<sf::Uint8, Counter> sent, /**< Sent packets by PacketType */
+      received;                      /**< Received packets by PacketType */
+  Counter sent_total,                /**< All sent packets */
+      received_total,                /**< All received packets */
+      sent_rate,     /**< Sent packets and bytes per second */
+      received_rate, /**< Received packets and bytes per second */
+      sent_before,   /**< sent_total at the start of the rate interval */
+      received_before; /**< received_total at the start of the rate
+                       interval */
+  sf::Int64 rate_start = 0; /**< Start in ms of the rate interval */
+
+  float rtt = -1,       /**< Smoothed round trip time in ms, -1 if unknown */
+      rtt_deviation = 0; /**< Smoothed deviation of rtt in ms */
+
+  size_t queue_bytes = 0, /**< Bytes waiting to be sent */
+      queue_packets = 0,  /**< Packets waiting to be sent */
+      max_queue_bytes = 0; /**< Max of queue_bytes */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Counts a completely sent packet.
+   *
+   * @param packet The packet.
+   */
+  void countSent(const sf::Packet& packet);
+
+  /**
+   * @brief Counts a received packet.
+   *
+   * @param packet The packet.
+   */
+  void countReceived(const sf::Packet& packet);
+
+  /**
+   * @brief Adds a measured round trip time.
+   *
+   * @param rtt The round trip time in ms.
+   */
+  void addRtt(sf::Int32 rtt);
+
+  /**
+   * @brief Sets the current size of the send queue.
+   *
+   * @param bytes Bytes waiting to be sent.
+   * @param packets Packets waiting to be sent.
+   */
+  void setQueue(size_t bytes, size_t packets);
+
+  /**
+   * @brief Calculates the rates if RATE_INTERVAL passed.
+   *
+   * @param now The current time in ms.
+   */
+  void update(sf::Int64 now);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  const std::map<sf::Uint8, Counter>& getSent() const { return this->sent; }
+
+  const std::map<sf::Uint8, Counter>& getReceived() const {
+    return this->received;
+  }
+
+  const Counter& getSentTotal() const { return this->sent_total; }
+
+  const Counter& getReceivedTotal() const { return this->received_total; }
+
+  const Counter& getSentRate() const { return this->sent_rate; }
+
+  const Counter& getReceivedRate() const { return this->received_rate; }
+
+  float getRtt() const { return this->rtt; }
+
+  float getRttDeviation() const { return this->rtt_deviation; }
+
+  size_t getQueueBytes() const { return this->queue_bytes; }
+
+  size_t getQueuePackets() const { return this->queue_packets; }
+
+  size_t getMaxQueueBytes() const { return this->max_queue_bytes; }
+
+  /**
+   * @brief Returns the PacketType of a packet.
+   *
+   * @param packet The packet, unread.
+   * @return int The type or -1 if the packet is empty.
+   */
+  static int getType(const sf::Packet& packet) {
+    if (packet.getDataSize() == 0) return -1;
+    return *(const sf::Uint8*)packet.getData();
+  }
+
+ private:
+  /**
+   * @brief Counts a packet.
+   *
+   * @param packet The packet.
+   * @param counters The counters by PacketType.
+   * @param total The counter of all packets.
+   */
+  static void count(const sf::Packet& packet,
+                    std::map<sf::Uint8, Counter>* counters, Counter* total);
+};
+}  // namespace Network
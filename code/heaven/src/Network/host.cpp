@@ -17,83 +17,45 @@ namespace Network {
 /* update() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::update() {
+  // Inputs of each client may simulate as much time as passed
+  float passed = this->input_clock.restart().asMicroseconds() / 1000.f;
+  for (auto& client : this->clients) {
+    float& time = this->input_time[client.first];
+    time = std::min(time + passed, (float)MAX_INPUT_BACKLOG);
+  }
+
   if (this->update_clock.getElapsedTime().asMilliseconds() >=
       SEND_UPDATE_INTERVAL) {
     this->update_clock.restart();
-    // Send all positions
-    for (auto& client : this->clients) {
-      // Send player pos
-      sf::Packet* position_packet =
-          playerSetPosPacket(0, this->world->getPlayer(0)->getPosition());
-      this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-          client.second, position_packet));
-
-      // Send enemy pos if could have changed
-      for (auto& enemy : this->enemy_ids) {
-        if (enemy.second->canMove()) {
-          sf::Packet* enemy_pos_packet = enemySetPosPacket(
-              (sf::Uint32)enemy.first, enemy.second->getPosition());
-          this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-              client.second, enemy_pos_packet));
-        }
-      }
-    }
+    // Changes of local players since the last network tick, final values
+    // only, so the send rate doesn't depend on the frame rate
+    for (auto player : this->world->getPlayers()) player->flushNetwork();
+    sendPositions();
   }
 
-  // Check new connections if not started yet
-  if (!this->world->isStarted()) {
-    sf::TcpSocket* new_socket = new sf::TcpSocket();
-    while (sf::Socket::Status::Done == this->tcp_listener.accept(*new_socket)) {
-      // New connection attempt
-      if (this->allow_add_player) {
-        // Not yet started -> new connection allowed
-        new_socket->setBlocking(false);
-
-        // Get id for new player
-        uint8_t new_id = 0;
-        while (this->player_ids.count(new_id) > 0) new_id++;
-
-        // Log to console
-        std::cout << "New player connected! Id: " << std::to_string(new_id)
-                  << ", ip: " << new_socket->getRemoteAddress().toString()
-                  << std::endl;
-
-        // Create entries for new player in maps
-        this->clients[new_id] = new_socket;
-        this->client_ips[new_id] = new_socket->getRemoteAddress();
-        this->player_ids[new_id] =
-            new Characters::Player(Characters::Player::START_POSITION, false);
-
-        // Add new player to world
-        this->world->addPlayer(this->player_ids[new_id]);
-        this->player_ids[new_id]->setName(std::to_string(new_id));
-
-        // Send start packets to new player
-        sendStart(new_id);
-      } else {
-        // Already started -> no new connections allowed
-        new_socket->disconnect();
-        delete new_socket;
-        break;
-      }
-      new_socket = new sf::TcpSocket();
-    }
+  if (pingDue()) {
+    sf::Uint32 now =
+        (sf::Uint32)this->stats_clock.getElapsedTime().asMilliseconds();
+    for (auto& client : this->clients)
+      queuePacket(client.first, pingPacket(client.first, now));
   }
 
-  // Send tcp
-  while (!this->send_tcp_packets.empty()) {
-    auto pair = this->send_tcp_packets.front();
-    sendTcpPacket(pair.first, pair.second);
-    delete pair.second;
-    this->send_tcp_packets.pop();
+  sendQueues();
+
+  // Only sockets with incoming data (or connections) are handled. Doesn't
+  // block.
+  if (this->selector.wait(sf::microseconds(1))) {
+    // Also while running, late joiners get the current world state
+    if (this->selector.isReady(this->tcp_listener)) acceptClients();
+    receiveTcp();
   }
-  // Receive tcp
-  receiveTcp();
+  addJoiningClients();
 
   // sendUdp();
   // receiveUdp();
 
   handleReceived();
+  updateStats();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -123,6 +85,7 @@ bool Host::start() {
 #ifdef DEBUG
   std::cout << "Done" << std::endl;
 #endif
+  this->selector.add(this->tcp_listener);
 
   // status = this->udp_socket->bind(this->udp_port);
   // switch (status) {
@@ -140,55 +103,320 @@ bool Host::start() {
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* acceptClients() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::acceptClients() {
+  while (true) {
+    sf::TcpSocket* new_socket = new sf::TcpSocket();
+    if (this->tcp_listener.accept(*new_socket) != sf::Socket::Status::Done) {
+      // No more connection attempts
+      delete new_socket;
+      break;
+    }
+
+    if (!this->allow_add_player ||
+        this->clients.size() + this->joining.size() >= this->max_players) {
+      // No new connections allowed
+      new_socket->disconnect();
+      delete new_socket;
+      break;
+    }
+
+    new_socket->setBlocking(false);
+    this->joining.push(new_socket);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* addJoiningClients() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::addJoiningClients() {
+  // Building the world state takes time, so it is spread over updates
+  for (size_t i = 0; i < MAX_JOINS_PER_UPDATE && !this->joining.empty();
+       i++) {
+    sf::TcpSocket* new_socket = this->joining.front();
+    this->joining.pop();
+
+    // Get id for new player
+    uint16_t new_id = 0;
+    while (this->player_ids.count(new_id) > 0) new_id++;
+
+    // Log to console
+    std::cout << "New player connected! Id: " << std::to_string(new_id)
+              << ", ip: " << new_socket->getRemoteAddress().toString()
+              << std::endl;
+
+    // Create entries for new player in maps
+    this->clients[new_id] = new_socket;
+    this->client_ips[new_id] = new_socket->getRemoteAddress();
+    this->selector.add(*new_socket);
+    this->player_ids[new_id] =
+        new Characters::Player(getSpawnPosition(), false);
+    // Moved by inputs of the client
+    this->player_ids[new_id]->setDrivenByInput(true);
+
+    // Add new player to world
+    this->world->addPlayer(this->player_ids[new_id]);
+    this->player_ids[new_id]->setName(std::to_string(new_id));
+
+    // Send start packets to new player
+    sendStart(new_id);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getSpawnPosition() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Vector2f Host::getSpawnPosition() const {
+  if (!this->world->isStarted() || this->world->getPlayers().empty())
+    return Characters::Player::START_POSITION;
+
+  sf::Vector2f pos = this->world->getPlayer(0)->getPosition();
+  for (auto p : this->world->getPlayers())
+    if (p->getPosition().y > pos.y) pos = p->getPosition();
+  return pos;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* isSender() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Host::isSender(uint16_t id) const {
+  if (id == this->received_link && this->clients.count(id) > 0 &&
+      this->player_ids.count(id) > 0)
+    return true;
+  std::cerr << "Error while handling received packet: Player "
+            << std::to_string(id) << " sent by client "
+            << std::to_string(this->received_link) << ", dropped."
+            << std::endl;
+  return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* removeClient() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::removeClient(uint16_t id) {
+  sf::TcpSocket* socket = this->clients[id];
+
+  this->send_queues[id].clear(&this->packet_pool);
+  this->send_queues.erase(id);
+  // Its packets must not reach the next client with this id
+  dropReceived(id);
+  this->stats.erase(id);
+  this->selector.remove(*socket);
+  this->clients.erase(id);
+  this->client_ips.erase(id);
+  this->player_priorities.erase(id);
+  this->enemy_priorities.erase(id);
+  this->last_inputs.erase(id);
+  this->acked_inputs.erase(id);
+  this->input_time.erase(id);
+  for (auto& priorities : this->player_priorities) priorities.second.erase(id);
+  Characters::Player* p = getPlayer(id);
+  this->world->deletePlayer(p);
+  this->player_ids.erase(id);
+  delete p;
+  delete socket;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* queuePacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::queuePacket(uint16_t id, sf::Packet* packet) {
+  // Removed (e.g. kicked for lagging) in this update
+  if (this->clients.count(id) == 0) {
+    this->packet_pool.release(packet);
+    return;
+  }
+  this->send_queues[id].push(packet, mergeKey(packet), &this->packet_pool);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* mergeKey() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Uint64 Host::mergeKey(const sf::Packet* packet) const {
+  const sf::Uint8* data = (const sf::Uint8*)packet->getData();
+  sf::Uint64 type = (sf::Uint64)data[0] + 1;  // Never NO_MERGE
+  switch ((PacketType)data[0]) {
+    case PacketType::PlayerSetPos:
+      // Id is sent as Uint16 in network byte order
+      return type << 32 | (sf::Uint32)data[1] << 8 | data[2];
+
+    case PacketType::EnemySetPos:
+    case PacketType::GroundSetPos:
+      // Id is sent as Uint32 in network byte order
+      return type << 32 | (sf::Uint32)data[1] << 24 |
+             (sf::Uint32)data[2] << 16 | (sf::Uint32)data[3] << 8 | data[4];
+
+    case PacketType::PlayerAck:
+      return type << 32;
+
+    default:
+      return SendQueue::NO_MERGE;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* sendQueues() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::sendQueues() {
+  std::vector<uint16_t> lagging;
+  for (auto& queue : this->send_queues) {
+    // Disconnects are noticed when receiving
+    queue.second.flush(this->clients[queue.first], &this->packet_pool,
+                       &this->stats[queue.first]);
+    this->stats[queue.first].setQueue(queue.second.getBytes(),
+                                      queue.second.size());
+    if (queue.second.getBytes() > this->max_queue_bytes ||
+        queue.second.getStallTime() > this->max_lag)
+      lagging.push_back(queue.first);
+  }
+
+  // Before receiveTcp() and handleReceived() of this update: whatever the
+  // client sent is dropped by removeClient() or never read
+  for (auto id : lagging) {
+    std::cout << "Player " << std::to_string(id)
+              << " is lagging too much, disconnecting." << std::endl;
+    this->clients.at(id)->disconnect();
+    removeClient(id);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* sendStart() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void Host::sendStart(uint8_t id) {
+void Host::sendStart(uint16_t id) {
   // Send accept player
   {
-    sf::Packet* accept_packet = new sf::Packet();
+    sf::Packet* accept_packet = this->packet_pool.acquire();
     *accept_packet << (sf::Uint8)PacketType::AcceptAddPlayer;
-    *accept_packet << (sf::Uint8)id;
-    this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-        this->clients[id], accept_packet));
+    *accept_packet << (sf::Uint16)id;
+    *accept_packet << (sf::Int64)getPlayer(id)->getPosition().x;
+    *accept_packet << (sf::Int64)getPlayer(id)->getPosition().y;
+    queuePacket(id, accept_packet);
   }
 
-  // Send add all other players
+  // Everything else is sent at once; other players only get the new one
+  updateGroundState();
+  std::vector<uint8_t> others;
   for (auto player : this->world->getPlayers()) {
     if (player == getPlayer(id)) continue;
-    if (player != this->world->getPlayer(0)) {
+    if (this->clients.count(getPlayerId(player)) > 0) {
       // Send the newly connected player to this player
       sf::Packet* add_packet = addPlayerPacket(id, getPlayer(id));
-      this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-          this->clients[getPlayerId(player)], add_packet));
+      queuePacket(getPlayerId(player), add_packet);
     }
-    // Add this player to the newly connected one
-    sf::Packet* packet = addPlayerPacket(getPlayerId(player), player);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(this->clients[id], packet));
+    appendToSection(&others, addPlayerPacket(getPlayerId(player), player));
   }
 
-  // Send add all grounds
-  for (auto ground : this->world->getGrounds()) {
-    sf::Packet* packet =
-        addGroundPacket((sf::Uint32)getGroundId(ground), ground);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(this->clients[id], packet));
-  }
+  for (auto enemy : this->world->getEnemies())
+    appendToSection(&others,
+                    addEnemyPacket((sf::Uint32)getEnemyId(enemy), enemy));
 
-  // Send add all enemies
-  for (auto enemy : this->world->getEnemies()) {
-    sf::Packet* packet = addEnemyPacket((sf::Uint32)getEnemyId(enemy), enemy);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(this->clients[id], packet));
-  }
+  for (auto collectable : this->world->getCollectables())
+    appendToSection(&others, addCollectablePacket(
+                                 (sf::Uint32)getCollectableId(collectable)));
 
-  // Send all collectables
-  for (auto collectable : this->world->getCollectables()) {
-    sf::Packet* packet =
-        addCollectablePacket((sf::Uint32)getCollectableId(collectable));
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(this->clients[id], packet));
+  // Race might already be running
+  if (this->world->getRaceDistance() > 0)
+    appendToSection(&others, setupRacePacket(this->world->getRaceDistance(),
+                                             this->world->isStarted(),
+                                             this->world->getRaceTime()));
+
+  std::vector<uint8_t> compressed =
+      Compression::compress(others.data(), others.size());
+  queuePacket(id, worldStatePacket(this->ground_state, this->ground_state_size,
+                                   compressed, (sf::Uint32)others.size()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* updateGroundState() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::updateGroundState() {
+  if (this->ground_state_valid) return;
+
+  std::vector<uint8_t> grounds;
+  for (auto ground : this->world->getGrounds())
+    appendToSection(&grounds,
+                    addGroundPacket((sf::Uint32)getGroundId(ground), ground));
+  this->ground_state = Compression::compress(grounds.data(), grounds.size());
+  this->ground_state_size = (sf::Uint32)grounds.size();
+  this->ground_state_valid = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* sendPositions() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::sendPositions() {
+  for (auto& client : this->clients) {
+    // Acknowledge last applied input (not part of the budget)
+    if (this->last_inputs.count(client.first) > 0 &&
+        this->acked_inputs[client.first] != this->last_inputs[client.first]) {
+      this->acked_inputs[client.first] = this->last_inputs[client.first];
+      sf::Packet* ack_packet =
+          playerAckPacket(this->last_inputs[client.first],
+                          getPlayer(client.first)->getMoveState());
+      queuePacket(client.first, ack_packet);
+    }
+
+    sf::Vector2f viewer = getPlayer(client.first)->getPosition();
+    std::map<uint16_t, float>& players = this->player_priorities[client.first];
+    std::map<size_t, float>& enemies = this->enemy_priorities[client.first];
+
+    // Accumulate priorities. Key of candidates: (priority, (is player, id))
+    std::vector<std::pair<float, std::pair<bool, size_t>>> candidates;
+    for (auto& player : this->player_ids) {
+      if (player.first == client.first) continue;
+      float& priority = players[player.first];
+      priority += gainedPriority(PLAYER_PRIORITY,
+                                 player.second->getPosition(), viewer);
+      candidates.push_back(std::make_pair(
+          priority, std::make_pair(true, (size_t)player.first)));
+    }
+    for (auto& enemy : this->enemy_ids) {
+      // Send enemy pos only if could have changed
+      if (!enemy.second->canMove()) continue;
+      float& priority = enemies[enemy.first];
+      priority +=
+          gainedPriority(ENEMY_PRIORITY, enemy.second->getPosition(), viewer);
+      candidates.push_back(
+          std::make_pair(priority, std::make_pair(false, enemy.first)));
+    }
+
+    // Highest priority first
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<float, std::pair<bool, size_t>>& a,
+                 const std::pair<float, std::pair<bool, size_t>>& b) {
+                return a.first > b.first;
+              });
+
+    // Fill budget
+    size_t used = 0;
+    for (auto& candidate : candidates) {
+      sf::Packet* packet;
+      if (candidate.second.first) {
+        sf::Uint16 id = (sf::Uint16)candidate.second.second;
+        packet = playerSetPosPacket(id, getPlayer(id)->getPosition());
+      } else {
+        size_t id = candidate.second.second;
+        packet = enemySetPosPacket((sf::Uint32)id, getEnemy(id)->getPosition());
+      }
+
+      // Packet size is sent as Uint32 in front of the data
+      size_t size = packet->getDataSize() + sizeof(sf::Uint32);
+      if (used + size > SEND_BUDGET) {
+        this->packet_pool.release(packet);
+        break;
+      }
+      used += size;
+      queuePacket(client.first, packet);
+
+      // Reset priority
+      if (candidate.second.first)
+        players[(uint16_t)candidate.second.second] = 0;
+      else
+        enemies[candidate.second.second] = 0;
+    }
   }
 }
 
@@ -196,13 +424,12 @@ void Host::sendStart(uint8_t id) {
 /* doAddPlayer() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doAddPlayer(Characters::Player* p) {
-  uint8_t id = 0;
+  uint16_t id = 0;
   while (this->player_ids.count(id) > 0) id++;
   this->player_ids[id] = p;
   for (auto client : this->clients) {
     sf::Packet* packet = addPlayerPacket(id, p);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -210,11 +437,10 @@ void Host::doAddPlayer(Characters::Player* p) {
 /* doPlayerChangeState() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doPlayerChangeState(const Characters::Player* p) {
-  uint8_t id = getPlayerId(p);
+  uint16_t id = getPlayerId(p);
   for (auto client : this->clients) {
     sf::Packet* packet = playerChangeStatePacket(id, p->getState());
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -222,12 +448,11 @@ void Host::doPlayerChangeState(const Characters::Player* p) {
 /* doPlayerHorizontalDir() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doPlayerHorizontalDir(const Characters::Player* p) {
-  uint8_t id = getPlayerId(p);
+  uint16_t id = getPlayerId(p);
   sf::Int8 dir = p->getDirection();
   for (auto client : this->clients) {
     sf::Packet* packet = playerHorizontalDirPacket(id, dir);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -235,11 +460,10 @@ void Host::doPlayerHorizontalDir(const Characters::Player* p) {
 /* doPlayerTakeDamage() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doPlayerTakeDamage(const Characters::Player* p, sf::Int8 damage) {
-  uint8_t id = getPlayerId(p);
+  uint16_t id = getPlayerId(p);
   for (auto client : this->clients) {
     sf::Packet* packet = playerTakeDamagePacket(id, damage);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -247,12 +471,11 @@ void Host::doPlayerTakeDamage(const Characters::Player* p, sf::Int8 damage) {
 /* doPlayerHeal() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doPlayerHeal(const Characters::Player* p, sf::Uint8 new_hp) {
-  sf::Uint8 id = getPlayerId(p);
+  sf::Uint16 id = getPlayerId(p);
 
   for (auto client : this->clients) {
     sf::Packet* packet = playerHealPacket(id, new_hp);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -263,10 +486,10 @@ void Host::doAddGround(Grounds::Ground* g) {
   size_t id = 0;
   while (this->ground_ids.count(id) > 0) id++;
   this->ground_ids[id] = g;
+  this->ground_state_valid = false;
   for (auto client : this->clients) {
     sf::Packet* packet = addGroundPacket((sf::Uint32)id, g);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -276,10 +499,10 @@ void Host::doAddGround(Grounds::Ground* g) {
 void Host::doGroundSetPos(const Grounds::Ground* g) {
   size_t id = getGroundId(g);
   sf::Vector2f pos(g->getGlobalBounds().left, g->getGlobalBounds().top);
+  this->ground_state_valid = false;
   for (auto client : this->clients) {
     sf::Packet* packet = groundSetPosPacket((sf::Uint32)id, pos);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -289,10 +512,10 @@ void Host::doGroundSetPos(const Grounds::Ground* g) {
 void Host::doRemoveGround(const Grounds::Ground* g) {
   size_t id = getGroundId(g);
   this->ground_ids.erase(id);
+  this->ground_state_valid = false;
   for (auto client : this->clients) {
     sf::Packet* packet = removeGroundPacket((sf::Uint32)id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -305,8 +528,7 @@ void Host::doAddEnemy(Characters::Enemy* e) {
   this->enemy_ids[id] = e;
   for (auto client : this->clients) {
     sf::Packet* packet = addEnemyPacket((sf::Uint32)id, e);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -317,8 +539,7 @@ void Host::doEnemyChangeState(const Characters::Enemy* e) {
   size_t id = getEnemyId(e);
   for (auto client : this->clients) {
     sf::Packet* packet = enemyChangeStatePacket((sf::Uint32)id, e->getState());
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -330,8 +551,7 @@ void Host::doEnemyHorizontalDir(const Characters::Enemy* e) {
   for (auto client : this->clients) {
     sf::Packet* packet =
         enemyHorizontalDirPacket((sf::Uint32)id, e->getDirection());
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -342,8 +562,7 @@ void Host::doEnemyDie(const Characters::Enemy* e) {
   size_t id = getEnemyId(e);
   for (auto client : this->clients) {
     sf::Packet* packet = enemyDiePacket((sf::Uint32)id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -353,10 +572,10 @@ void Host::doEnemyDie(const Characters::Enemy* e) {
 void Host::doRemoveEnemy(const Characters::Enemy* e) {
   size_t id = getEnemyId(e);
   this->enemy_ids.erase(id);
+  for (auto& priorities : this->enemy_priorities) priorities.second.erase(id);
   for (auto client : this->clients) {
     sf::Packet* packet = removeEnemyPacket((sf::Uint32)id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -369,8 +588,7 @@ void Host::doAddCollectable(Collectables::Collectable* c) {
   this->collectable_ids[id] = c;
   for (auto client : this->clients) {
     sf::Packet* packet = addCollectablePacket((sf::Uint32)id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 }
 
@@ -383,9 +601,8 @@ void Host::doCollectableCollected(const Collectables::Collectable* c,
   size_t c_id = getCollectableId(c), p_id = getPlayerId(p);
   for (auto client : this->clients) {
     sf::Packet* packet =
-        collectableCollectedPacket((sf::Uint32)c_id, (sf::Uint8)p_id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+        collectableCollectedPacket((sf::Uint32)c_id, (sf::Uint16)p_id);
+    queuePacket(client.first, packet);
   }
 
   // Apply to self
@@ -400,8 +617,7 @@ void Host::doRemoveCollectable(const Collectables::Collectable* c) {
   size_t id = getCollectableId(c);
   for (auto client : this->clients) {
     sf::Packet* packet = removeCollectablePacket((sf::Uint32)id);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 
   // Apply to self
@@ -413,9 +629,9 @@ void Host::doRemoveCollectable(const Collectables::Collectable* c) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doSetupRace(sf::Uint16 distance) {
   for (auto client : this->clients) {
-    sf::Packet* packet = setupRacePacket(distance);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    sf::Packet* packet = setupRacePacket(distance, this->world->isStarted(),
+                                         this->world->getRaceTime());
+    queuePacket(client.first, packet);
   }
 }
 
@@ -423,11 +639,10 @@ void Host::doSetupRace(sf::Uint16 distance) {
 /* doDeclareWinner() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::doDeclareWinner(Characters::Player* p, sf::Uint32 time) {
-  sf::Uint8 id = getPlayerId(p);
+  sf::Uint16 id = getPlayerId(p);
   for (auto client : this->clients) {
     sf::Packet* packet = declareWinnerPacket(id, time);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, packet));
+    queuePacket(client.first, packet);
   }
 
   // Set for self
@@ -524,50 +739,43 @@ void Host::doDeclareWinner(Characters::Player* p, sf::Uint32 time) {
 /* receiveTcp() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::receiveTcp() {
-  // Receive udp packets
-  sf::Packet* packet = new sf::Packet();
-  bool deleted = false;
+  sf::Packet* packet = this->packet_pool.acquire();
+  std::vector<uint16_t> disconnected;
   for (auto client : this->clients) {
-    while (true) {
+    if (!this->selector.isReady(*client.second)) continue;
+
+    // Read everything available
+    bool reading = true;
+    while (reading) {
       sf::Socket::Status status = client.second->receive(*packet);
       switch (status) {
         case sf::Socket::Status::Done:
-          this->receive_tcp_packets.push(packet);
-          packet = new sf::Packet();
-          continue;
-          break;
-
-        case sf::Socket::Status::Partial:
-          continue;
+          pushReceivedTcp(client.first, packet);
+          packet = this->packet_pool.acquire();
           break;
 
-        case sf::Socket::Status::Disconnected: {
+        case sf::Socket::Status::Disconnected:
           std::cerr << "Error while receiving tcp packet: Code " << status
                     << " Disconnected." << std::endl;
-          this->clients.erase(client.first);
-          this->client_ips.erase(client.first);
-          Characters::Player* p = getPlayer(client.first);
-          this->world->deletePlayer(p);
-          this->player_ids.erase(client.first);
-          delete p;
-          delete client.second;
-          deleted = true;
+          disconnected.push_back(client.first);
+          reading = false;
           break;
-        }
 
         case sf::Socket::Status::Error:
           std::cerr << "Error while receiving tcp packet: Code " << status
                     << " Error." << std::endl;
+          reading = false;
           break;
 
-        case sf::Socket::Status::NotReady:
+        default:  // Partial: rest is received next time
+          reading = false;
           break;
       }
-      break;
     }
-    if (deleted) break;
   }
-  delete packet;
+  this->packet_pool.release(packet);
+
+  for (auto id : disconnected) removeClient(id);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -584,7 +792,7 @@ void Host::handleWantAddPlayer(sf::Packet* packet) {
   *packet >> y;
   sf::Vector2f pos((float)x, (float)y);
   if (this->allow_add_player) {
-    uint8_t id = 0;
+    uint16_t id = 0;
     while (this->player_ids.count(id) > 0) id++;
     this->player_ids[id] = new Characters::Player(pos, false);
     this->world->addPlayer(this->player_ids[id]);
@@ -592,11 +800,10 @@ void Host::handleWantAddPlayer(sf::Packet* packet) {
 
     // Send accept player
     {
-      sf::Packet* accept_packet = new sf::Packet();
+      sf::Packet* accept_packet = this->packet_pool.acquire();
       *accept_packet << (sf::Uint8)PacketType::AcceptAddPlayer;
-      *accept_packet << (sf::Uint8)id;
-      this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-          this->clients[id], accept_packet));
+      *accept_packet << (sf::Uint16)id;
+      queuePacket(id, accept_packet);
     }
 
     // Send add all other players
@@ -605,13 +812,11 @@ void Host::handleWantAddPlayer(sf::Packet* packet) {
       if (player != this->world->getPlayer(0)) {
         // Send the newly connected player to this player
         sf::Packet* add_packet = addPlayerPacket(id, getPlayer(id));
-        this->send_tcp_packets.push(std::pair<sf::TcpSocket*, sf::Packet*>(
-            this->clients[getPlayerId(player)], add_packet));
+        queuePacket(getPlayerId(player), add_packet);
       }
       // Add this player to the newly connected one
       sf::Packet* packet = addPlayerPacket(getPlayerId(player), player);
-      this->send_tcp_packets.push(
-          std::pair<sf::TcpSocket*, sf::Packet*>(this->clients[id], packet));
+      queuePacket(id, packet);
     }
   }
   */
@@ -637,38 +842,32 @@ void Host::handleAcceptAddPlayer(sf::Packet* packet) {
 /* handlePlayerSetPos() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::handlePlayerSetPos(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int64 x, y;
   *packet >> x;
   *packet >> y;
+  if (!isSender(id)) return;
   getPlayer(id)->setPosition((float)x, (float)y);
-  // Send this to others to
-  for (auto client : this->clients) {
-    if (client.first == id) continue;
-    sf::Packet* send_to_others =
-        playerSetPosPacket(id, sf::Vector2f((float)x, (float)y));
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, send_to_others));
-  }
+  // Sent to others by sendPositions()
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* handlePlayerChangeState() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::handlePlayerChangeState(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Uint8 state;
   *packet >> state;
+  if (!isSender(id)) return;
   getPlayer(id)->setState((Characters::Character::State)state);
   // Send this to others to
   for (auto client : this->clients) {
     if (client.first == id) continue;
     sf::Packet* send_to_others =
         playerChangeStatePacket(id, (Characters::Character::State)state);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, send_to_others));
+    queuePacket(client.first, send_to_others);
   }
 }
 
@@ -676,10 +875,11 @@ void Host::handlePlayerChangeState(sf::Packet* packet) {
 /* handlePlayerHorizontalDir() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::handlePlayerHorizontalDir(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int8 dir;
   *packet >> dir;
+  if (!isSender(id)) return;
   if (dir < 0)
     getPlayer(id)->setMoveDirLeft(0);
   else if (dir > 0)
@@ -691,8 +891,7 @@ void Host::handlePlayerHorizontalDir(sf::Packet* packet) {
   for (auto client : this->clients) {
     if (client.first == id) continue;
     sf::Packet* send_to_others = playerHorizontalDirPacket(id, dir);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, send_to_others));
+    queuePacket(client.first, send_to_others);
   }
 }
 
@@ -700,18 +899,18 @@ void Host::handlePlayerHorizontalDir(sf::Packet* packet) {
 /* handlePlayerTakeDamage() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::handlePlayerTakeDamage(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Int8 damage;
   *packet >> damage;
+  if (!isSender(id)) return;
   getPlayer(id)->takeDamage(damage);
 
   // Send this to others to
   for (auto client : this->clients) {
     if (client.first == id) continue;
     sf::Packet* send_to_others = playerTakeDamagePacket(id, damage);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, send_to_others));
+    queuePacket(client.first, send_to_others);
   }
 }
 
@@ -719,18 +918,18 @@ void Host::handlePlayerTakeDamage(sf::Packet* packet) {
 /* handlePlayerHeal() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void Host::handlePlayerHeal(sf::Packet* packet) {
-  sf::Uint8 id;
+  sf::Uint16 id;
   *packet >> id;
   sf::Uint8 new_hp;
   *packet >> new_hp;
+  if (!isSender(id)) return;
   getPlayer(id)->setHP(new_hp);
 
   // Send this to others to
   for (auto client : this->clients) {
     if (client.first == id) continue;
     sf::Packet* send_to_others = playerHealPacket(id, new_hp);
-    this->send_tcp_packets.push(
-        std::pair<sf::TcpSocket*, sf::Packet*>(client.second, send_to_others));
+    queuePacket(client.first, send_to_others);
   }
 }
 
@@ -846,4 +1045,74 @@ void Host::handleDeclareWinner(sf::Packet* packet) {
   std::cerr << "Error while handling received packet: DeclareWinner must "
             << "not be sent to the host!" << std::endl;
 }
-}  // namespace Network
\ No newline at end of file
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePlayerInput() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::handlePlayerInput(sf::Packet* packet) {
+  sf::Uint16 id;
+  *packet >> id;
+  sf::Uint32 sequence;
+  *packet >> sequence;
+  sf::Int8 dir;
+  *packet >> dir;
+  sf::Uint8 jump;
+  *packet >> jump;
+  if (!isSender(id)) return;
+
+  // Old or repeated inputs
+  if (this->last_inputs.count(id) > 0 && sequence <= this->last_inputs[id])
+    return;
+  // Not more steps than time passed (a client sending faster isn't faster)
+  float step = INPUT_STEP * 100.f;
+  if (this->input_time[id] < step) return;
+  this->input_time[id] -= step;
+
+  // Simulate one step with this input. Position is sent to all clients by
+  // sendPositions(), the result acknowledged to the sender.
+  Characters::Player* p = getPlayer(id);
+  applyPlayerInput(p, dir, jump != 0);
+  this->world->simulateCharacter(p, INPUT_STEP);
+  this->last_inputs[id] = sequence;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePlayerAck() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::handlePlayerAck(sf::Packet* packet) {
+  std::cerr << "Error while handling received packet: PlayerAck must "
+            << "not be sent to the host!" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handleWorldState() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::handleWorldState(sf::Packet* packet) {
+  std::cerr << "Error while handling received packet: WorldState must "
+            << "not be sent to the host!" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePing() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::handlePing(sf::Packet* packet) {
+  sf::Uint16 id;
+  sf::Uint32 time;
+  *packet >> id;
+  *packet >> time;
+  if (isSender(id)) queuePacket(id, pongPacket(id, time));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePong() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Host::handlePong(sf::Packet* packet) {
+  sf::Uint16 id;
+  sf::Uint32 time;
+  *packet >> id;
+  *packet >> time;
+  if (!isSender(id)) return;
+  this->stats[id].addRtt(
+      this->stats_clock.getElapsedTime().asMilliseconds() - (sf::Int32)time);
+}
+}  // namespace Network
@@ -11,22 +11,91 @@
 
 #pragma once
 
+#include <math.h>
+
+#include <algorithm>
+
 #include "network_manager.h"
+#include "send_queue.h"
 
 namespace Network {
 /** \class Host
  *  @brief NetworkManager as host.
  */
 class Host : public NetworkManager {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t SEND_BUDGET =
+      512; /**< Max bytes of position updates sent to one client
+           every SEND_UPDATE_INTERVAL */
+
+  static const size_t MAX_QUEUE_BYTES =
+      65536; /**< Default for max bytes waiting to be sent to one client */
+
+  static const size_t MAX_PLAYERS =
+      255; /**< Default for max connected clients */
+
+  static const sf::Int32 MAX_LAG =
+      3000; /**< Default for max time in ms a client may not take any data */
+
+  static const size_t MAX_JOINS_PER_UPDATE =
+      1; /**< Max clients getting the world state in one update */
+
+  static const sf::Int32 MAX_INPUT_BACKLOG =
+      200; /**< Max time in ms of inputs a client may send ahead of the host
+           (e.g. delayed ones arriving at once), more are dropped */
+
+  static constexpr float
+      PLAYER_PRIORITY = 2.f,    /**< Priority gained per interval by players */
+      ENEMY_PRIORITY = 1.f,     /**< Priority gained per interval by enemies */
+      PRIORITY_DISTANCE = 500.f; /**< Distance at which the gained priority
+                                 is halved */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  private:
   sf::TcpListener tcp_listener;
-  std::map<uint8_t, sf::TcpSocket*> clients;   /**< Player id with socket */
-  std::map<uint8_t, sf::IpAddress> client_ips; /**< Player id with ip addr */
+  sf::SocketSelector selector; /**< Waits for the listener and all clients */
+  std::queue<sf::TcpSocket*>
+      joining; /**< Accepted sockets waiting to get the world state */
+  std::map<uint16_t, SendQueue>
+      send_queues; /**< Player id with packets waiting to be sent */
+
+  size_t max_queue_bytes =
+      MAX_QUEUE_BYTES; /**< Clients with more bytes waiting are disconnected */
+  sf::Int32 max_lag = MAX_LAG; /**< Clients not taking any data for longer (in
+                               ms) are disconnected */
+  std::map<uint16_t, sf::TcpSocket*> clients;   /**< Player id with socket */
+  std::map<uint16_t, sf::IpAddress> client_ips; /**< Player id with ip addr */
 
   bool allow_add_player = true; /**< Can be set to false to deny new players */
+  size_t max_players = MAX_PLAYERS; /**< Max connected clients */
+
+  std::map<uint16_t, std::map<uint16_t, float>>
+      player_priorities; /**< Key: client id; val: accumulated priority of
+                         each player's position for this client */
+  std::map<uint16_t, std::map<size_t, float>>
+      enemy_priorities; /**< Key: client id; val: accumulated priority of
+                        each enemy's position for this client */
+
+  std::map<uint16_t, sf::Uint32>
+      last_inputs,  /**< Key: client id; val: sequence of last applied input */
+      acked_inputs; /**< Key: client id; val: sequence of last acknowledged
+                    input */
+  std::map<uint16_t, float>
+      input_time;     /**< Key: client id; val: time in ms its inputs may
+                      still simulate (grows with the time passed) */
+  sf::Clock input_clock; /**< Time since input_time was last increased */
+
+  std::vector<uint8_t> ground_state; /**< Compressed grounds section of
+                                     WorldState, shared by all joiners */
+  sf::Uint32 ground_state_size = 0;  /**< Size of ground_state before
+                                     compression */
+  bool ground_state_valid = false;   /**< False if grounds were added or
+                                     removed since ground_state was made */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -46,7 +115,9 @@ class Host : public NetworkManager {
   Host(World* world, uint16_t udp_port = UDP_PORT, uint16_t tcp_port = TCP_PORT)
       : NetworkManager(world, udp_port, tcp_port) {
     this->tcp_listener.setBlocking(false);
-    this->player_ids[0] = this->world->getPlayer(0);
+    // A dedicated server has no player of its own
+    if (this->world->getPlayers().size() > 0)
+      this->player_ids[0] = this->world->getPlayer(0);
 
     // Add all grounds
     std::vector<Grounds::Ground*> grounds = this->world->getGrounds();
@@ -79,6 +150,13 @@ class Host : public NetworkManager {
    *
    */
   virtual ~Host() {
+    this->selector.clear();
+    for (auto& queue : this->send_queues) queue.second.clear(&this->packet_pool);
+    while (!this->joining.empty()) {
+      this->joining.front()->disconnect();
+      delete this->joining.front();
+      this->joining.pop();
+    }
     for (auto client : this->clients) {
       client.second->disconnect();
       delete client.second;
@@ -91,6 +169,8 @@ class Host : public NetworkManager {
 
   bool isHost() const override { return true; }
 
+  Host* asHost() override { return this; }
+
   void update() override;
 
   /**
@@ -101,14 +181,146 @@ class Host : public NetworkManager {
    */
   bool start();
 
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Sets the lag threshold for disconnecting clients.
+   *
+   * @param max_queue_bytes Max bytes waiting to be sent to one client.
+   * @param max_lag Max time in ms a client may not take any data.
+   */
+  void setMaxLag(size_t max_queue_bytes, sf::Int32 max_lag) {
+    this->max_queue_bytes = max_queue_bytes;
+    this->max_lag = max_lag;
+  }
+
+  /**
+   * @brief Sets the max number of connected clients.
+   *
+   * @param max_players The max number, at most 65535 (ids are Uint16).
+   */
+  void setMaxPlayers(size_t max_players) {
+    this->max_players = max_players < 0xFFFF ? max_players : 0xFFFF;
+  }
+
  private:
+  /**
+   * @brief Accepts all pending connections of new clients.
+   *
+   * Only called if the listener is ready, so no socket is created in vain.
+   * The accepted sockets are added by addJoiningClients().
+   */
+  void acceptClients();
+
+  /**
+   * @brief Adds at most MAX_JOINS_PER_UPDATE accepted clients to the world
+   * and sends them the world state.
+   *
+   * Also works while the game is running. Clients waiting longer aren't read
+   * from, so they can't send anything before having the world state.
+   */
+  void addJoiningClients();
+
+  /**
+   * @brief Checks that a packet about a player came from the client of that
+   * player, so no client can drive another player.
+   *
+   * @param id The player id in the packet.
+   * @return true If the packet being handled came from client id.
+   */
+  bool isSender(uint16_t id) const;
+
+  /**
+   * @brief Calculates where a new player is added.
+   *
+   * @return sf::Vector2f START_POSITION if the game didn't start yet;
+   * otherwise the position of the lowest player, as the scenes around
+   * START_POSITION might be gone.
+   */
+  sf::Vector2f getSpawnPosition() const;
+
+  /**
+   * @brief Queues a packet for a client.
+   *
+   * Packets for ids that aren't connected (anymore) are released, so no send
+   * queue is made for a removed client.
+   *
+   * @param id The id of the client.
+   * @param packet Pointer to the packet (from packet_pool).
+   */
+  void queuePacket(uint16_t id, sf::Packet* packet);
+
+  /**
+   * @brief Returns the key for merging a packet in the send queue.
+   *
+   * Newer positions of the same entity and newer acks replace queued ones.
+   *
+   * @param packet Pointer to the packet.
+   * @return sf::Uint64 The key or SendQueue::NO_MERGE.
+   */
+  sf::Uint64 mergeKey(const sf::Packet* packet) const;
+
+  /**
+   * @brief Sends the queued packets of all clients.
+   *
+   * Clients exceeding max_queue_bytes or max_lag are disconnected, so that a
+   * slow client doesn't stall the others.
+   */
+  void sendQueues();
+
+  /**
+   * @brief Removes a disconnected client and its player.
+   *
+   * Packets it sent that aren't handled yet are dropped.
+   *
+   * @param id The id of the client.
+   */
+  void removeClient(uint16_t id);
+
   /**
    * @brief Sends all packets needed for a client when first connected to this
    * host.
    *
+   * Everything except the accept is sent in one WorldState packet.
+   *
    * @param id The id of the new client.
    */
-  void sendStart(uint8_t id);
+  void sendStart(uint16_t id);
+
+  /**
+   * @brief Compresses the grounds section of WorldState again if grounds
+   * were added or removed.
+   *
+   */
+  void updateGroundState();
+
+  /**
+   * @brief Queues the position updates for every client.
+   *
+   * Acknowledges the last applied input of the client's player first.
+   * Each player and movable enemy accumulates priority every interval,
+   * weighted by its type and its distance to the client's player. The
+   * updates are then queued from highest to lowest priority until
+   * SEND_BUDGET is used up. Skipped updates keep their priority and
+   * will be sent in one of the next intervals.
+   */
+  void sendPositions();
+
+  /**
+   * @brief Calculates the priority gained in one interval.
+   *
+   * @param weight The weight of the entity type.
+   * @param entity Position of the entity.
+   * @param viewer Position of the client's player.
+   * @return float The priority to add.
+   */
+  float gainedPriority(float weight, const sf::Vector2f& entity,
+                       const sf::Vector2f& viewer) const {
+    float dx = entity.x - viewer.x, dy = entity.y - viewer.y;
+    return weight / (1.f + sqrtf(dx * dx + dy * dy) / PRIORITY_DISTANCE);
+  }
 
   // ----------------------------------------- //
   /* From World Methods */
@@ -159,6 +371,11 @@ class Host : public NetworkManager {
 
   // void receiveUdp();
 
+  /**
+   * @brief Receives all packets of clients that are ready.
+   *
+   * Must only be called after the selector waited.
+   */
   void receiveTcp();
 
   // ----------------------------------------- //
@@ -208,5 +425,15 @@ class Host : public NetworkManager {
   virtual void handleSetupRace(sf::Packet* packet) override;
 
   virtual void handleDeclareWinner(sf::Packet* packet) override;
+
+  virtual void handlePlayerInput(sf::Packet* packet) override;
+
+  virtual void handlePlayerAck(sf::Packet* packet) override;
+
+  virtual void handleWorldState(sf::Packet* packet) override;
+
+  virtual void handlePing(sf::Packet* packet) override;
+
+  virtual void handlePong(sf::Packet* packet) override;
 };
 }  // namespace Network
\ No newline at end of file
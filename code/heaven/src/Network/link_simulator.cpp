@@ -0,0 +1,132 @@
+/**
+ * @file link_simulator.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for LinkSimulator class.
+ * @version 0.1
+ * @date 2020-02-09
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "link_simulator.h"
+
+#include <sstream>
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* push() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void LinkSimulator::push(sf::Packet* packet, sf::Int64 now,
+                         bool reorderable) {
+  std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+  // Time on the wire
+  sf::Int64 sent = now > this->link_free ? now : this->link_free;
+  if (this->conditions.bandwidth > 0)
+    sent += (sf::Int64)packet->getDataSize() * 1000 /
+             (sf::Int64)this->conditions.bandwidth;
+  this->link_free = sent;
+
+  float delay = (float)this->conditions.delay + drawJitter();
+  if (delay < 0) delay = 0;
+  sf::Int64 arrival = sent + (sf::Int64)delay;
+  if (chance(this->random) < this->conditions.loss)
+    arrival += this->conditions.retransmit;
+
+  // Drawn for every packet, the values don't depend on the packet types
+  bool reorder = chance(this->random) < this->conditions.reorder;
+  if (reorder && reorderable) {
+    // Not held back by earlier packets
+    this->packets.insert(std::make_pair(arrival, packet));
+    return;
+  }
+
+  if (arrival < this->last_arrival) arrival = this->last_arrival;
+  this->last_arrival = arrival;
+  this->packets.insert(std::make_pair(arrival, packet));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* pop() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* LinkSimulator::pop(sf::Int64 now) {
+  if (this->packets.empty() || this->packets.begin()->first > now)
+    return nullptr;
+  sf::Packet* packet = this->packets.begin()->second;
+  this->packets.erase(this->packets.begin());
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* clear() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void LinkSimulator::clear(PacketPool* pool) {
+  for (auto& pair : this->packets) pool->release(pair.second);
+  this->packets.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* parse() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool LinkSimulator::parse(const std::string& spec, Conditions* conditions) {
+  std::stringstream stream(spec);
+  std::string option;
+  while (std::getline(stream, option, ',')) {
+    size_t split = option.find('=');
+    if (split == std::string::npos) return false;
+    std::string key = option.substr(0, split),
+                value = option.substr(split + 1);
+    try {
+      if (key == "delay")
+        conditions->delay = std::stoi(value);
+      else if (key == "jitter")
+        conditions->jitter = std::stoi(value);
+      else if (key == "retransmit")
+        conditions->retransmit = std::stoi(value);
+      else if (key == "loss")
+        conditions->loss = std::stof(value);
+      else if (key == "reorder")
+        conditions->reorder = std::stof(value);
+      else if (key == "bandwidth")
+        conditions->bandwidth = (size_t)std::stoul(value);
+      else if (key == "seed")
+        conditions->seed = (sf::Uint32)std::stoul(value);
+      else if (key == "dist" && value == "uniform")
+        conditions->distribution = Distribution::Uniform;
+      else if (key == "dist" && value == "normal")
+        conditions->distribution = Distribution::Normal;
+      else if (key == "dist" && value == "exponential")
+        conditions->distribution = Distribution::Exponential;
+      else
+        return false;
+    } catch (const std::exception&) {
+      return false;
+    }
+  }
+  return conditions->delay >= 0 && conditions->jitter >= 0 &&
+         conditions->retransmit >= 0 && conditions->loss >= 0 &&
+         conditions->loss <= 1 && conditions->reorder >= 0 &&
+         conditions->reorder <= 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* drawJitter() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float LinkSimulator::drawJitter() {
+  if (this->conditions.jitter == 0) return 0;
+  float jitter = (float)this->conditions.jitter;
+  switch (this->conditions.distribution) {
+    case Distribution::Normal:
+      return std::normal_distribution<float>(0.f, jitter)(this->random);
+
+    case Distribution::Exponential:
+      return std::exponential_distribution<float>(1.f / jitter)(this->random);
+
+    default:
+      return std::uniform_real_distribution<float>(-jitter,
+                                                   jitter)(this->random);
+  }
+}
+}  // namespace Network
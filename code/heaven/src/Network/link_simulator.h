@@ -0,0 +1,162 @@
+/**
+ * @file link_simulator.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for LinkSimulator class.
+ * @version 0.1
+ * @date 2020-02-09
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <map>
+#include <random>
+#include <string>
+
+#include "packet_pool.h"
+
+namespace Network {
+/** \class LinkSimulator
+ *  @brief Simulates a bad network for the packets received over one
+ * connection.
+ *
+ * Received packets are held back until their simulated arrival time. The
+ * delay is Conditions::delay plus a random jitter. A lost packet arrives
+ * Conditions::retransmit ms later, like a tcp retransmission. Like tcp, later
+ * packets wait for it, unless they are reordered. Only packets the caller
+ * marks as reorderable can overtake others, so e.g. an Add* packet still
+ * arrives before everything that refers to its id. The bandwidth delays
+ * packets by their size. All random values are taken from a generator seeded
+ * with Conditions::seed, so runs with the same conditions and traffic are
+ * reproducible.
+ */
+class LinkSimulator {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief Distribution of the jitter.
+   */
+  enum class Distribution : uint8_t {
+    Uniform,    /**< Between -jitter and jitter */
+    Normal,     /**< Standard deviation of jitter */
+    Exponential /**< Mean of jitter, only positive (long tail) */
+  };
+
+  /**
+   * @brief Conditions of a simulated link.
+   */
+  struct Conditions {
+    sf::Int32 delay = 0,   /**< Base delay in ms */
+        jitter = 0,        /**< Jitter in ms, see distribution */
+        retransmit = 200;  /**< Extra delay in ms of a lost packet */
+    Distribution distribution = Distribution::Uniform; /**< Of the jitter */
+    float loss = 0,     /**< Probability of a packet to be lost */
+        reorder = 0;    /**< Probability of a reorderable packet to
+                          overtake others */
+    size_t bandwidth = 0; /**< Bytes per second, 0 for unlimited */
+    sf::Uint32 seed = 0;  /**< Seed of the random values */
+
+    /**
+     * @brief Checks whether packets are changed at all.
+     *
+     * @return true If any condition is set.
+     * @return false Otherwise.
+     */
+    bool isActive() const {
+      return delay > 0 || jitter > 0 || loss > 0 || reorder > 0 ||
+             bandwidth > 0;
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  Conditions conditions; /**< Conditions of this link */
+
+  std::mt19937 random; /**< Generator for all random values */
+
+  std::multimap<sf::Int64, sf::Packet*>
+      packets; /**< Held back packets by arrival time in ms */
+
+  sf::Int64 last_arrival = 0, /**< Arrival time of the last ordered packet */
+      link_free = 0; /**< Time in ms the link is done with the last packet */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new LinkSimulator object.
+   *
+   * @param conditions The conditions of the link.
+   */
+  LinkSimulator(const Conditions& conditions)
+      : conditions(conditions), random(conditions.seed) {}
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Holds back a received packet.
+   *
+   * @param packet The packet.
+   * @param now The current time in ms.
+   * @param reorderable Whether the packet may overtake earlier packets.
+   */
+  void push(sf::Packet* packet, sf::Int64 now, bool reorderable);
+
+  /**
+   * @brief Takes the next packet that arrived.
+   *
+   * @param now The current time in ms.
+   * @return sf::Packet* The packet or nullptr if none arrived yet.
+   */
+  sf::Packet* pop(sf::Int64 now);
+
+  /**
+   * @brief Gives all held back packets back to the pool.
+   *
+   * @param pool The pool.
+   */
+  void clear(PacketPool* pool);
+
+  /**
+   * @brief Reads conditions from a string.
+   *
+   * The string is a comma separated list of key=value with the keys delay,
+   * jitter, dist (uniform, normal or exponential), loss, retransmit,
+   * reorder, bandwidth and seed, e.g. "delay=80,jitter=20,loss=0.01".
+   *
+   * @param spec The string.
+   * @param conditions Output for the conditions.
+   * @return true On success.
+   * @return false If spec is invalid.
+   */
+  static bool parse(const std::string& spec, Conditions* conditions);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  size_t size() const { return this->packets.size(); }
+
+ private:
+  /**
+   * @brief Draws the jitter of one packet.
+   *
+   * @return float The jitter in ms.
+   */
+  float drawJitter();
+};
+}  // namespace Network
@@ -11,18 +11,17 @@
 
 #include "network_manager.h"
 
-namespace Network {
+#include <algorithm>
+#include <sstream>
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-/* Static Variables */
-///////////////////////////////////////////////////////////////////////////////////////////////////
+#include "../trace.h"
 
-NetworkManager* NetworkManager::instance = nullptr;
+namespace Network {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* showPlayerWon() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-void NetworkManager::showPlayerWon(sf::Uint8 id, sf::Uint32 time) {
+void NetworkManager::showPlayerWon(sf::Uint16 id, sf::Uint32 time) {
   // Calculate minutes, seconds and ms from time
   uint16_t minutes = (uint16_t)(sf::milliseconds(time).asSeconds() / 60);
   uint8_t seconds =
@@ -44,41 +43,309 @@ void NetworkManager::showPlayerWon(sf::Uint8 id, sf::Uint32 time) {
   this->world->setRaceDistance(0);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* applyPlayerInput() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::applyPlayerInput(Characters::Player* player, sf::Int8 dir,
+                                      bool jump) {
+  if (dir != player->getDirection()) {
+    if (dir < 0)
+      player->setMoveDirLeft(0);
+    else if (dir > 0)
+      player->setMoveDirRight(0);
+    else
+      player->setHorizontalMovement(0);
+  }
+  if (jump != player->keepsJumping()) player->setJump(jump);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* sendTcpPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-bool NetworkManager::sendTcpPacket(sf::TcpSocket* socket, sf::Packet* packet) {
+sf::Socket::Status NetworkManager::sendTcpPacket(sf::TcpSocket* socket,
+                                                 sf::Packet* packet) {
   // Send tcp packets
-  while (true) {
-    sf::Socket::Status status = socket->send(*packet);
-    switch (status) {
-      case sf::Socket::Status::Done:
-        break;
+  sf::Socket::Status status = socket->send(*packet);
+  switch (status) {
+    case sf::Socket::Status::Disconnected:
+      std::cerr << "Error while sending tcp packet: Code " << status
+                << " Disconnected." << std::endl;
+      break;
+
+    case sf::Socket::Status::Error:
+      std::cerr << "Error while sending tcp packet: Code " << status
+                << " Error." << std::endl;
+      break;
+
+    default:
+      break;
+  }
+  return status;
+}
 
-      case sf::Socket::Status::Partial:
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* sendQueuedTcp() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::sendQueuedTcp() {
+  std::set<sf::TcpSocket*> stalled;  // Sockets that can't take more data
+  size_t count = this->send_tcp_packets.size(), queue_bytes = 0;
+  for (size_t i = 0; i < count; i++) {
+    auto pair = this->send_tcp_packets.front();
+    this->send_tcp_packets.pop();
+
+    if (stalled.count(pair.first) == 0) {
+      sf::Socket::Status status = sendTcpPacket(pair.first, pair.second);
+      if (status != sf::Socket::Status::Partial &&
+          status != sf::Socket::Status::NotReady) {
+        if (status == sf::Socket::Status::Done) {
+          this->stats[0].countSent(*pair.second);
+          Trace::instant("send", "network", "bytes",
+                         pair.second->getDataSize(), "type",
+                         ConnectionStats::getType(*pair.second));
+        }
+        this->packet_pool.release(pair.second);
         continue;
-        break;
-
-      case sf::Socket::Status::Disconnected:
-        std::cerr << "Error while sending tcp packet: Code " << status
-                  << " Disconnected." << std::endl;
-        return false;
-        break;
-
-      case sf::Socket::Status::Error:
-        std::cerr << "Error while sending tcp packet: Code " << status
-                  << " Error." << std::endl;
-        return false;
-        break;
-
-      case sf::Socket::Status::NotReady:
-        break;
+      }
+      stalled.insert(pair.first);
     }
-    break;
+
+    // Continue next time
+    this->send_tcp_packets.push(pair);
+    queue_bytes += pair.second->getDataSize() + sizeof(sf::Uint32);
+  }
+  this->stats[0].setQueue(queue_bytes, this->send_tcp_packets.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* pushReceivedTcp() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::pushReceivedTcp(uint16_t link, sf::Packet* packet) {
+  this->stats[link].countReceived(*packet);
+  Trace::instant("receive", "network", "bytes", packet->getDataSize(), "type",
+                 ConnectionStats::getType(*packet));
+
+  if (this->links.count(link) == 0) {
+    if (!this->link_conditions.isActive()) {
+      this->receive_tcp_packets.push(std::make_pair(link, packet));
+      return;
+    }
+    // Same seed for every connection
+    this->links.insert(
+        std::make_pair(link, LinkSimulator(this->link_conditions)));
+  }
+  // Only positions can overtake others, their handlers skip unknown ids.
+  // Every other packet may refer to an id added or removed before it.
+  int type = ConnectionStats::getType(*packet);
+  bool reorderable = type == (int)PacketType::PlayerSetPos ||
+                     type == (int)PacketType::EnemySetPos;
+  this->links.at(link).push(packet,
+                            this->link_clock.getElapsedTime().asMilliseconds(),
+                            reorderable);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* receiveLinks() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::receiveLinks() {
+  sf::Int64 now = this->link_clock.getElapsedTime().asMilliseconds();
+  for (auto& link : this->links) {
+    sf::Packet* packet;
+    while ((packet = link.second.pop(now)))
+      this->receive_tcp_packets.push(std::make_pair(link.first, packet));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* dropReceived() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::dropReceived(uint16_t link) {
+  if (this->links.count(link) > 0) {
+    this->links.at(link).clear(&this->packet_pool);
+    this->links.erase(link);
+  }
+
+  // Keep the order of the others
+  for (size_t i = this->receive_tcp_packets.size(); i > 0; i--) {
+    auto pair = this->receive_tcp_packets.front();
+    this->receive_tcp_packets.pop();
+    if (pair.first == link)
+      this->packet_pool.release(pair.second);
+    else
+      this->receive_tcp_packets.push(pair);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* updateStats() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::updateStats() {
+  sf::Int64 now = this->stats_clock.getElapsedTime().asMilliseconds();
+  for (auto& connection : this->stats) connection.second.update(now);
+
+  if (this->stats_file.is_open() &&
+      now - this->last_stats_write >= STATS_INTERVAL) {
+    this->last_stats_write = now;
+    writeStats(this->stats_file);
+    this->stats_file.flush();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* pingDue() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool NetworkManager::pingDue() {
+  sf::Int64 now = this->stats_clock.getElapsedTime().asMilliseconds();
+  if (now - this->last_ping < PING_INTERVAL) return false;
+  this->last_ping = now;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setStatsFile() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool NetworkManager::setStatsFile(const std::string& file) {
+  this->stats_file.open(file, std::ios::out | std::ios::app);
+  if (!this->stats_file.is_open()) {
+    std::cerr << "Error while opening stats file: " << file << std::endl;
+    return false;
   }
   return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* writeStats() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::writeStats(std::ostream& out) const {
+  auto writeCounter = [&](const ConnectionStats::Counter& counter) {
+    out << "{\"packets\":" << counter.packets << ",\"bytes\":" << counter.bytes
+        << "}";
+  };
+  auto writeTypes =
+      [&](const std::map<sf::Uint8, ConnectionStats::Counter>& types) {
+        out << "{";
+        for (auto it = types.begin(); it != types.end(); it++) {
+          if (it != types.begin()) out << ",";
+          out << "\"" << getPacketTypeName(it->first) << "\":";
+          writeCounter(it->second);
+        }
+        out << "}";
+      };
+
+  out << "{\"time\":" << this->stats_clock.getElapsedTime().asMilliseconds()
+      << ",\"host\":" << (isHost() ? "true" : "false")
+      << ",\"connections\":[";
+  for (auto it = this->stats.begin(); it != this->stats.end(); it++) {
+    const ConnectionStats& connection = it->second;
+    if (it != this->stats.begin()) out << ",";
+    out << "{\"id\":" << it->first << ",\"rtt\":" << connection.getRtt()
+        << ",\"rtt_deviation\":" << connection.getRttDeviation()
+        << ",\"sent\":";
+    writeCounter(connection.getSentTotal());
+    out << ",\"sent_per_second\":";
+    writeCounter(connection.getSentRate());
+    out << ",\"sent_by_type\":";
+    writeTypes(connection.getSent());
+    out << ",\"received\":";
+    writeCounter(connection.getReceivedTotal());
+    out << ",\"received_per_second\":";
+    writeCounter(connection.getReceivedRate());
+    out << ",\"received_by_type\":";
+    writeTypes(connection.getReceived());
+    out << ",\"queue\":{\"packets\":" << connection.getQueuePackets()
+        << ",\"bytes\":" << connection.getQueueBytes()
+        << ",\"max_bytes\":" << connection.getMaxQueueBytes() << "}}";
+  }
+  out << "]}" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getLogText() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> NetworkManager::getLogText() const {
+  std::vector<std::string> logs;
+  std::map<sf::Uint8, ConnectionStats::Counter> sent, received;
+  for (auto& connection : this->stats) {
+    const ConnectionStats& c = connection.second;
+    std::stringstream line;
+    line.precision(1);
+    line << std::fixed << "Connection " << connection.first << ": rtt ";
+    if (c.getRtt() < 0)
+      line << "-";
+    else
+      line << c.getRtt() << " ms (+-" << c.getRttDeviation() << ")";
+    line << ", out " << c.getSentRate().bytes << " B/s "
+         << c.getSentRate().packets << " pkt/s, in "
+         << c.getReceivedRate().bytes << " B/s "
+         << c.getReceivedRate().packets << " pkt/s, queue "
+         << c.getQueuePackets() << " pkt " << c.getQueueBytes() << " B (max "
+         << c.getMaxQueueBytes() << " B)";
+    logs.push_back(line.str());
+
+    for (auto& type : c.getSent()) {
+      sent[type.first].packets += type.second.packets;
+      sent[type.first].bytes += type.second.bytes;
+    }
+    for (auto& type : c.getReceived()) {
+      received[type.first].packets += type.second.packets;
+      received[type.first].bytes += type.second.bytes;
+    }
+  }
+
+  // Types with most bytes first
+  std::vector<sf::Uint8> types;
+  for (auto& type : sent) types.push_back(type.first);
+  for (auto& type : received)
+    if (sent.count(type.first) == 0) types.push_back(type.first);
+  std::sort(types.begin(), types.end(), [&](sf::Uint8 a, sf::Uint8 b) {
+    return sent[a].bytes + received[a].bytes >
+           sent[b].bytes + received[b].bytes;
+  });
+  for (auto type : types)
+    logs.push_back("  " + getPacketTypeName(type) + ": out " +
+                   std::to_string(sent[type].bytes) + " B (" +
+                   std::to_string(sent[type].packets) + "), in " +
+                   std::to_string(received[type].bytes) + " B (" +
+                   std::to_string(received[type].packets) + ")");
+  return logs;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getPacketTypeName() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+std::string NetworkManager::getPacketTypeName(sf::Uint8 type) {
+  static const char* NAMES[] = {
+      "WantAddPlayer",
+      "AddPlayer",
+      "AcceptAddPlayer",
+      "PlayerSetPos",
+      "PlayerChangeState",
+      "PlayerHorizontalDir",
+      "PlayerTakeDamage",
+      "PlayerHeal",
+      "AddGround",
+      "GroundSetPos",
+      "RemoveGround",
+      "AddEnemy",
+      "EnemySetPos",
+      "EnemyChangeState",
+      "EnemyHorizontalDir",
+      "EnemyDie",
+      "RemoveEnemy",
+      "AddCollectable",
+      "CollectableCollected",
+      "RemoveCollectable",
+      "SetupRace",
+      "DeclareWinner",
+      "PlayerInput",
+      "PlayerAck",
+      "WorldState",
+      "Ping",
+      "Pong",
+  };
+  if (type <= (sf::Uint8)PacketType::Pong) return NAMES[type];
+  return "Unknown" + std::to_string(type);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* wantaddPlayerPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -86,7 +353,7 @@ sf::Packet* NetworkManager::wantAddPlayerPacket(const sf::Vector2f& position) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::wantAddPlayerPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::WantAddPlayer;
   *packet << (sf::Int64)position.x;
   *packet << (sf::Int64)position.y;
@@ -96,9 +363,9 @@ sf::Packet* NetworkManager::wantAddPlayerPacket(const sf::Vector2f& position) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* playerSetPosPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::playerSetPosPacket(sf::Uint8 id,
+sf::Packet* NetworkManager::playerSetPosPacket(sf::Uint16 id,
                                                const sf::Vector2f& position) {
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::PlayerSetPos;
   *packet << id;
   *packet << (sf::Int64)position.x;
@@ -110,8 +377,8 @@ sf::Packet* NetworkManager::playerSetPosPacket(sf::Uint8 id,
 /* playerChangeStatePacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Packet* NetworkManager::playerChangeStatePacket(
-    sf::Uint8 id, Characters::Character::State new_state) {
-  sf::Packet* packet = new sf::Packet();
+    sf::Uint16 id, Characters::Character::State new_state) {
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::PlayerChangeState;
   *packet << id;
   *packet << (sf::Uint8)new_state;
@@ -121,12 +388,12 @@ sf::Packet* NetworkManager::playerChangeStatePacket(
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* playerHorizontalDirPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::playerHorizontalDirPacket(sf::Uint8 id,
+sf::Packet* NetworkManager::playerHorizontalDirPacket(sf::Uint16 id,
                                                       sf::Int8 dir) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::playerHorizontalDirPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::PlayerHorizontalDir;
   *packet << id;
   *packet << dir;
@@ -141,7 +408,7 @@ sf::Packet* NetworkManager::addGroundPacket(sf::Uint32 id,
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::addGroundPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::AddGround;
   *packet << (sf::Uint32)getGroundId(ground);
   *packet << (sf::Int64)ground->getGlobalBounds().left;
@@ -161,14 +428,14 @@ sf::Packet* NetworkManager::addGroundPacket(sf::Uint32 id,
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* addPlayerPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::addPlayerPacket(sf::Uint8 id,
+sf::Packet* NetworkManager::addPlayerPacket(sf::Uint16 id,
                                             Characters::Player* player) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::addPlayerPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::AddPlayer;
-  *packet << (sf::Uint8)id;
+  *packet << (sf::Uint16)id;
   *packet << (sf::Int64)getPlayer(id)->getPosition().x;
   *packet << (sf::Int64)getPlayer(id)->getPosition().y;
   *packet << (sf::Uint8)getPlayer(id)->getState();
@@ -184,7 +451,7 @@ sf::Packet* NetworkManager::addEnemyPacket(sf::Uint32 id,
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::addEnemyPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::AddEnemy;
   *packet << id;
   *packet << (sf::Int64)enemy->getPosition().x;
@@ -200,7 +467,7 @@ sf::Packet* NetworkManager::addEnemyPacket(sf::Uint32 id,
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Packet* NetworkManager::enemySetPosPacket(sf::Uint32 id,
                                               const sf::Vector2f& position) {
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::EnemySetPos;
   *packet << id;
   *packet << (sf::Int64)position.x;
@@ -213,7 +480,7 @@ sf::Packet* NetworkManager::enemySetPosPacket(sf::Uint32 id,
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Packet* NetworkManager::enemyChangeStatePacket(
     sf::Uint32 id, Characters::Character::State state) {
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::EnemyChangeState;
   *packet << id;
   *packet << (sf::Uint8)state;
@@ -225,7 +492,7 @@ sf::Packet* NetworkManager::enemyChangeStatePacket(
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Packet* NetworkManager::enemyHorizontalDirPacket(sf::Uint32 id,
                                                      sf::Int8 dir) {
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::EnemyHorizontalDir;
   *packet << id;
   *packet << dir;
@@ -239,7 +506,7 @@ sf::Packet* NetworkManager::enemyDiePacket(sf::Uint32 id) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::enemyDiePacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::EnemyDie;
   *packet << id;
   return packet;
@@ -248,12 +515,12 @@ sf::Packet* NetworkManager::enemyDiePacket(sf::Uint32 id) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* playerTakeDamagePacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::playerTakeDamagePacket(sf::Uint8 id,
+sf::Packet* NetworkManager::playerTakeDamagePacket(sf::Uint16 id,
                                                    sf::Int8 damage) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::playerTakeDamagePacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::PlayerTakeDamage;
   *packet << id;
   *packet << damage;
@@ -263,11 +530,11 @@ sf::Packet* NetworkManager::playerTakeDamagePacket(sf::Uint8 id,
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* playerHealPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::playerHealPacket(sf::Uint8 id, sf::Int8 new_hp) {
+sf::Packet* NetworkManager::playerHealPacket(sf::Uint16 id, sf::Int8 new_hp) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::playerHealPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::PlayerHeal;
   *packet << id;
   *packet << new_hp;
@@ -281,7 +548,7 @@ sf::Packet* NetworkManager::addCollectablePacket(sf::Uint32 id) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::addCollectablePacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::AddCollectable;
   *packet << id;
   *packet << (sf::Int64)getCollectable(id)->getPosition().x;
@@ -294,11 +561,11 @@ sf::Packet* NetworkManager::addCollectablePacket(sf::Uint32 id) {
 /* collectableCollectedPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 sf::Packet* NetworkManager::collectableCollectedPacket(sf::Uint32 id,
-                                                       sf::Uint8 player) {
+                                                       sf::Uint16 player) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::collectableCollectedPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::CollectableCollected;
   *packet << id;
   *packet << player;
@@ -312,7 +579,7 @@ sf::Packet* NetworkManager::removeCollectablePacket(sf::Uint32 id) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::removeCollectablePacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::RemoveCollectable;
   *packet << id;
   return packet;
@@ -325,7 +592,7 @@ sf::Packet* NetworkManager::removeEnemyPacket(sf::Uint32 id) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::removeEnemyPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::RemoveEnemy;
   *packet << id;
   return packet;
@@ -338,7 +605,7 @@ sf::Packet* NetworkManager::removeGroundPacket(sf::Uint32 id) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::removeGroundPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::RemoveGround;
   *packet << id;
   return packet;
@@ -352,7 +619,7 @@ sf::Packet* NetworkManager::groundSetPosPacket(sf::Uint32 id,
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::groundSetPosPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::GroundSetPos;
   *packet << id;
   *packet << (sf::Int64)position.x;
@@ -363,140 +630,144 @@ sf::Packet* NetworkManager::groundSetPosPacket(sf::Uint32 id,
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* setupRacePacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::setupRacePacket(sf::Uint16 distance) {
+sf::Packet* NetworkManager::setupRacePacket(sf::Uint16 distance, bool started,
+                                            sf::Uint32 time) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::setupRacePacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::SetupRace;
   *packet << distance;
+  *packet << (sf::Uint8)started;
+  *packet << time;
   return packet;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* declareWinnerPacket() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-sf::Packet* NetworkManager::declareWinnerPacket(sf::Uint8 id, sf::Uint32 time) {
+sf::Packet* NetworkManager::declareWinnerPacket(sf::Uint16 id,
+                                                sf::Uint32 time) {
 #ifdef NETWORK_VERBOSE
   std::cout << "NetworkManager::declareWinnerPacket" << std::endl;
 #endif
-  sf::Packet* packet = new sf::Packet();
+  sf::Packet* packet = this->packet_pool.acquire();
   *packet << (sf::Uint8)PacketType::DeclareWinner;
   *packet << id;
   *packet << time;
   return packet;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* playerInputPacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* NetworkManager::playerInputPacket(sf::Uint16 id,
+                                              sf::Uint32 sequence,
+                                              sf::Int8 dir, bool jump) {
+  sf::Packet* packet = this->packet_pool.acquire();
+  *packet << (sf::Uint8)PacketType::PlayerInput;
+  *packet << id;
+  *packet << sequence;
+  *packet << dir;
+  *packet << (sf::Uint8)jump;
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* playerAckPacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* NetworkManager::playerAckPacket(
+    sf::Uint32 sequence, const Characters::Character::MoveState& move_state) {
+  sf::Packet* packet = this->packet_pool.acquire();
+  *packet << (sf::Uint8)PacketType::PlayerAck;
+  *packet << sequence;
+  *packet << move_state.position.x;
+  *packet << move_state.position.y;
+  *packet << move_state.vertical_speed;
+  *packet << move_state.jump_time;
+  *packet << (sf::Int8)move_state.horizontal_movement;
+  *packet << (sf::Uint8)(move_state.on_ground | move_state.keeps_jumping << 1 |
+                         move_state.can_keep_jumping << 2);
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* worldStatePacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* NetworkManager::worldStatePacket(const std::vector<uint8_t>& grounds,
+                                             sf::Uint32 grounds_size,
+                                             const std::vector<uint8_t>& others,
+                                             sf::Uint32 others_size) {
+  sf::Packet* packet = this->packet_pool.acquire();
+  *packet << (sf::Uint8)PacketType::WorldState;
+  *packet << grounds_size;
+  *packet << (sf::Uint32)grounds.size();
+  packet->append(grounds.data(), grounds.size());
+  *packet << others_size;
+  *packet << (sf::Uint32)others.size();
+  packet->append(others.data(), others.size());
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* appendToSection() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::appendToSection(std::vector<uint8_t>* data,
+                                     sf::Packet* packet) {
+  // Size in network byte order, like sf::Packet does
+  sf::Uint32 size = (sf::Uint32)packet->getDataSize();
+  data->push_back((uint8_t)(size >> 24));
+  data->push_back((uint8_t)(size >> 16));
+  data->push_back((uint8_t)(size >> 8));
+  data->push_back((uint8_t)size);
+  const uint8_t* bytes = (const uint8_t*)packet->getData();
+  data->insert(data->end(), bytes, bytes + size);
+  this->packet_pool.release(packet);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* pingPacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* NetworkManager::pingPacket(sf::Uint16 id, sf::Uint32 time) {
+  sf::Packet* packet = this->packet_pool.acquire();
+  *packet << (sf::Uint8)PacketType::Ping;
+  *packet << id;
+  *packet << time;
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* pongPacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* NetworkManager::pongPacket(sf::Uint16 id, sf::Uint32 time) {
+  sf::Packet* packet = this->packet_pool.acquire();
+  *packet << (sf::Uint8)PacketType::Pong;
+  *packet << id;
+  *packet << time;
+  return packet;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* handleReceived() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void NetworkManager::handleReceived() {
+  Trace::Scope trace("handleReceived", "network");
+  receiveLinks();
+
   sf::Packet* packet;
   while (!this->receive_tcp_packets.empty() ||
          !this->receive_udp_packets.empty()) {
-    if (!this->receive_tcp_packets.empty())
-      packet = this->receive_tcp_packets.front();
-    else
+    if (!this->receive_tcp_packets.empty()) {
+      this->received_link = this->receive_tcp_packets.front().first;
+      packet = this->receive_tcp_packets.front().second;
+    } else {
+      this->received_link = 0;
       packet = this->receive_udp_packets.front();
-    PacketType type;
-    sf::Uint8 t;
-    *packet >> t;
-    type = (PacketType)t;
-
-    switch (type) {
-      case PacketType::WantAddPlayer:
-        handleWantAddPlayer(packet);
-        break;
-
-      case PacketType::AddPlayer:
-        handleAddPlayer(packet);
-        break;
-
-      case PacketType::AcceptAddPlayer:
-        handleAcceptAddPlayer(packet);
-        break;
-
-      case PacketType::PlayerSetPos:
-        handlePlayerSetPos(packet);
-        break;
-
-      case PacketType::PlayerChangeState:
-        handlePlayerChangeState(packet);
-        break;
-
-      case PacketType::PlayerHorizontalDir:
-        handlePlayerHorizontalDir(packet);
-        break;
-
-      case PacketType::PlayerTakeDamage:
-        handlePlayerTakeDamage(packet);
-        break;
-
-      case PacketType::PlayerHeal:
-        handlePlayerHeal(packet);
-        break;
-
-      case PacketType::AddGround:
-        handleAddGround(packet);
-        break;
-
-      case PacketType::GroundSetPos:
-        handleGroundSetPos(packet);
-        break;
-
-      case PacketType::RemoveGround:
-        handleRemoveGround(packet);
-        break;
-
-      case PacketType::AddEnemy:
-        handleAddEnemy(packet);
-        break;
-
-      case PacketType::EnemySetPos:
-        handleEnemySetPos(packet);
-        break;
-
-      case PacketType::EnemyChangeState:
-        handleEnemyChangeState(packet);
-        break;
-
-      case PacketType::EnemyHorizontalDir:
-        handleEnemyHorizontalDir(packet);
-        break;
-
-      case PacketType::EnemyDie:
-        handleEnemyDie(packet);
-        break;
-
-      case PacketType::RemoveEnemy:
-        handleRemoveEnemy(packet);
-        break;
-
-      case PacketType::AddCollectable:
-        handleAddCollectable(packet);
-        break;
-
-      case PacketType::CollectableCollected:
-        handleCollectableCollected(packet);
-        break;
-
-      case PacketType::RemoveCollectable:
-        handleRemoveCollectable(packet);
-        break;
-
-      default:
-        std::cerr << "Error while handling received packet: "
-                     "Unknown PacketType: "
-                  << std::to_string(t) << std::endl;
-        break;
     }
-#ifdef DEBUG
-    if (!packet->endOfPacket())
-      std::cerr << "Error while handling received packet: Packet wasn't read "
-                   "completely. Type: "
-                << std::to_string(t) << std::endl;
-#endif
-    delete packet;
+
+    if (this->recorder) this->recorder->recordPacket(*packet);
+    handlePacket(packet);
+    this->packet_pool.release(packet);
 
     if (!this->receive_tcp_packets.empty())
       this->receive_tcp_packets.pop();
@@ -504,4 +775,136 @@ void NetworkManager::handleReceived() {
       this->receive_udp_packets.pop();
   }
 }
-}  // namespace Network
\ No newline at end of file
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* handlePacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void NetworkManager::handlePacket(sf::Packet* packet) {
+  PacketType type;
+  sf::Uint8 t;
+  *packet >> t;
+  type = (PacketType)t;
+
+  switch (type) {
+    case PacketType::WantAddPlayer:
+      handleWantAddPlayer(packet);
+      break;
+
+    case PacketType::AddPlayer:
+      handleAddPlayer(packet);
+      break;
+
+    case PacketType::AcceptAddPlayer:
+      handleAcceptAddPlayer(packet);
+      break;
+
+    case PacketType::PlayerSetPos:
+      handlePlayerSetPos(packet);
+      break;
+
+    case PacketType::PlayerChangeState:
+      handlePlayerChangeState(packet);
+      break;
+
+    case PacketType::PlayerHorizontalDir:
+      handlePlayerHorizontalDir(packet);
+      break;
+
+    case PacketType::PlayerTakeDamage:
+      handlePlayerTakeDamage(packet);
+      break;
+
+    case PacketType::PlayerHeal:
+      handlePlayerHeal(packet);
+      break;
+
+    case PacketType::AddGround:
+      handleAddGround(packet);
+      break;
+
+    case PacketType::GroundSetPos:
+      handleGroundSetPos(packet);
+      break;
+
+    case PacketType::RemoveGround:
+      handleRemoveGround(packet);
+      break;
+
+    case PacketType::AddEnemy:
+      handleAddEnemy(packet);
+      break;
+
+    case PacketType::EnemySetPos:
+      handleEnemySetPos(packet);
+      break;
+
+    case PacketType::EnemyChangeState:
+      handleEnemyChangeState(packet);
+      break;
+
+    case PacketType::EnemyHorizontalDir:
+      handleEnemyHorizontalDir(packet);
+      break;
+
+    case PacketType::EnemyDie:
+      handleEnemyDie(packet);
+      break;
+
+    case PacketType::RemoveEnemy:
+      handleRemoveEnemy(packet);
+      break;
+
+    case PacketType::AddCollectable:
+      handleAddCollectable(packet);
+      break;
+
+    case PacketType::CollectableCollected:
+      handleCollectableCollected(packet);
+      break;
+
+    case PacketType::RemoveCollectable:
+      handleRemoveCollectable(packet);
+      break;
+
+    case PacketType::SetupRace:
+      handleSetupRace(packet);
+      break;
+
+    case PacketType::DeclareWinner:
+      handleDeclareWinner(packet);
+      break;
+
+    case PacketType::PlayerInput:
+      handlePlayerInput(packet);
+      break;
+
+    case PacketType::PlayerAck:
+      handlePlayerAck(packet);
+      break;
+
+    case PacketType::WorldState:
+      handleWorldState(packet);
+      break;
+
+    case PacketType::Ping:
+      handlePing(packet);
+      break;
+
+    case PacketType::Pong:
+      handlePong(packet);
+      break;
+
+    default:
+      std::cerr << "Error while handling received packet: "
+                   "Unknown PacketType: "
+                << std::to_string(t) << std::endl;
+      break;
+  }
+#ifdef DEBUG
+  if (!packet->endOfPacket())
+    std::cerr << "Error while handling received packet: Packet wasn't read "
+                 "completely. Type: "
+              << std::to_string(t) << std::endl;
+#endif
+}
+}  // namespace Network
@@ -12,9 +12,16 @@
 #pragma once
 
 #include <SFML/Network.hpp>
+#include <fstream>
 #include <queue>
+#include <set>
 
+#include "../recorder.h"
 #include "../world.h"
+#include "compression.h"
+#include "connection_stats.h"
+#include "link_simulator.h"
+#include "packet_pool.h"
 
 /**
  * @brief Namespace for all Network classes.
@@ -22,8 +29,15 @@
  */
 namespace Network {
 
+class Host;
+class Client;
+
 /** \class NetworkManager
  *  @brief Base class for Host and Client.
+ *
+ * A NetworkManager belongs to one World: it sets itself as the network of its
+ * world on construction and removes itself on destruction. There can be any
+ * number of them in a process, one per world (e.g. many races on a server).
  */
 class NetworkManager {
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,20 +68,21 @@ class NetworkManager {
     WantAddPlayer,       /**< player pos x(Int64) and y(Int64)
                          are following
                          (can only be sent by clients) */
-    AddPlayer,           /**< player id(Uint8), player pos x(Int64) and
+    AddPlayer,           /**< player id(Uint16), player pos x(Int64) and
                          y(Int64), state(Uint8) and direction(Int8)
                          are following (can only be sent by host) */
-    AcceptAddPlayer,     /**< player id(Uint8) is following
-                         (can only be sent by host) */
-    PlayerSetPos,        /**< player id(Uint8), pos x(Int64) and
+    AcceptAddPlayer,     /**< player id(Uint16), pos x(Int64) and y(Int64)
+                         are following (can only be sent by host) */
+    PlayerSetPos,        /**< player id(Uint16), pos x(Int64) and
                          y(Int64) for sender player are following */
-    PlayerChangeState,   /**< player id(Uint8) and state(Uint8)
+    PlayerChangeState,   /**< player id(Uint16) and state(Uint8)
                          are following */
-    PlayerHorizontalDir, /**< player id(Uint8) and direction(Int8)
+    PlayerHorizontalDir, /**< player id(Uint16) and direction(Int8)
                          are following */
-    PlayerTakeDamage,    /**< player id(Uint8) and amount of damage(Int8)
+    PlayerTakeDamage,    /**< player id(Uint16) and amount of damage(Int8)
+                         are following */
+    PlayerHeal,          /**< player id(Uint16) and new hp(Int8)
                          are following */
-    PlayerHeal,          /**< player id(Uint8) and new hp(Int8) are following */
     AddGround,           /**< ground id(Uint32), pos x(Int64) and
                          y(Int64), width(Uint32) and height(Uint32)
                          and type(GroundType) are following;
@@ -100,14 +115,34 @@ class NetworkManager {
     AddCollectable,      /**< collectable id(Uint32), pos x(Int64)
                          and y(Int64) and type(CollectableType) are following
                          (can only be sent by host) */
-    CollectableCollected, /**< collectable id(Uint32) and player id(Uint8)
+    CollectableCollected, /**< collectable id(Uint32) and player id(Uint16)
                          are following
                           (can only be sent by host) */
     RemoveCollectable,    /**< collectable id(Uint32) is following
                          (can only be sent by host) */
-    SetupRace,            /**< Race distance(Int16) is following */
-    DeclareWinner         /**< player id(Uint8) and time in ms(Uint32)
+    SetupRace,            /**< Race distance(Uint16), started(Uint8) and
+                          race time in ms(Uint32) are following */
+    DeclareWinner,        /**< player id(Uint16) and time in ms(Uint32)
                           is following */
+    PlayerInput,          /**< player id(Uint16), sequence(Uint32),
+                          direction(Int8) and jump(Uint8) are following
+                          (can only be sent by clients) */
+    PlayerAck,            /**< sequence(Uint32) of last applied input,
+                          pos x(float) and y(float), vertical speed(float),
+                          jump time(float), direction(Int8) and
+                          flags(Uint8: on ground, keeps jumping,
+                          can keep jumping) are following
+                          (can only be sent by host) */
+    WorldState,           /**< two sections (grounds, then players, enemies
+                          and collectables) are following, each as raw
+                          size(Uint32), compressed size(Uint32) and the
+                          compressed bytes(Uint8); raw data are packets
+                          each as size(Uint32) and data
+                          (can only be sent by host) */
+    Ping,                 /**< connection id(Uint16: client's player id) and
+                          time in ms(Uint32) of the sender are following */
+    Pong                  /**< connection id(Uint16) and time(Uint32) of
+                          the answered Ping are following */
   };
 
   static const uint16_t UDP_PORT = 2309, /**< The standard udp port used. */
@@ -117,6 +152,16 @@ class NetworkManager {
       10; /**< The minumum interval in ms to wait before
            sendng new positions. */
 
+  static constexpr float INPUT_STEP =
+      SEND_UPDATE_INTERVAL / 100.f; /**< Time factor of one step of a
+                                    predicted player (one input) */
+
+  static const sf::Int32 PING_INTERVAL =
+      1000; /**< Interval in ms to measure the round trip time */
+
+  static const sf::Int32 STATS_INTERVAL =
+      1000; /**< Interval in ms to write the stats to the stats file */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -125,7 +170,7 @@ class NetworkManager {
   uint16_t udp_port = 0,  /**< Port for udp_socket */
       tcp_port = 0;       /**< Port for tcp_socket */
 
-  std::map<uint8_t, Characters::Player*>
+  std::map<uint16_t, Characters::Player*>
       player_ids; /**< Key: id (by host) of player;
                   val: pointer to player in local world */
   std::map<size_t, Grounds::Ground*>
@@ -144,15 +189,35 @@ class NetworkManager {
                         (if sending/receiving is moved to other thread) */
 
   std::queue<sf::Packet*>
-      receive_udp_packets, /**< Queue for receiving udp packets to host
+      receive_udp_packets; /**< Queue for receiving udp packets to host
                            (if sending/receiving is moved to other thread) */
-      receive_tcp_packets; /**< Queue for receiving tcp packets to host
-                           (if sending/receiving is moved to other thread) */
-
-  sf::Clock
-      update_clock; /**< Clock to measure time until next send of positions */
-
-  static NetworkManager* instance; /**< Current instance of NetworkManager */
+  std::queue<std::pair<uint16_t, sf::Packet*>>
+      receive_tcp_packets; /**< Received tcp packets with the connection they
+                           came from (player id for host, 0 for client) */
+  uint16_t received_link =
+      0; /**< Connection the packet being handled came from */
+
+  sf::Clock update_clock; /**< Clock to measure time until the next network
+                          tick (flush of the players, send of positions) */
+
+  PacketPool packet_pool; /**< Pool for all sent and received packets */
+
+  LinkSimulator::Conditions
+      link_conditions; /**< Simulated conditions of received packets */
+  std::map<uint16_t, LinkSimulator>
+      links; /**< Key: connection (player id for host, 0 for client);
+             val: its simulated link, only if link_conditions are active */
+  sf::Clock link_clock; /**< Time for the simulated links */
+
+  std::map<uint16_t, ConnectionStats>
+      stats; /**< Key: connection (player id for host, 0 for client);
+             val: its traffic */
+  sf::Clock stats_clock;   /**< Time for stats and pings */
+  sf::Int64 last_ping = 0, /**< Time in ms the last pings were sent */
+      last_stats_write = 0; /**< Time in ms stats_file was written last */
+  std::ofstream stats_file; /**< File the stats are written to, if open */
+
+  Recorder* recorder = nullptr; /**< Records all handled packets, if set */
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Methods */
@@ -163,7 +228,8 @@ class NetworkManager {
   // ----------------------------------------- //
 
   /**
-   * @brief Constructs a new Network Manager object.
+   * @brief Constructs a new Network Manager object and sets it as the network
+   * of the world.
    *
    * @param world Pointer to the world.
    * @param udp_port Port for udp connections.
@@ -172,44 +238,40 @@ class NetworkManager {
   NetworkManager(World* world, uint16_t udp_port = UDP_PORT,
                  uint16_t tcp_port = TCP_PORT)
       : world(world) {
-    if (instance) {
-      std::cerr << "Error while creating NetworkManager: Only one can be "
-                   "existent at any time."
-                << std::endl;
-      exit(1);
-    }
     this->udp_port = udp_port;
     this->tcp_port = tcp_port;
-    instance = this;
+    if (this->world) this->world->setNetwork(this);
   }
 
   /**
-   * @brief Destroys the Network Manager object.
+   * @brief Destroys the Network Manager object and removes it from the world.
    *
    */
   virtual ~NetworkManager() {
     while (!this->send_tcp_packets.empty()) {
       auto pair = this->send_tcp_packets.front();
-      delete pair.second;
+      this->packet_pool.release(pair.second);
       this->send_tcp_packets.pop();
     }
     while (!this->send_udp_packets.empty()) {
       auto pair = this->send_udp_packets.front();
-      delete pair.second;
+      this->packet_pool.release(pair.second);
       this->send_udp_packets.pop();
     }
     while (!this->receive_tcp_packets.empty()) {
-      auto packet = this->receive_tcp_packets.front();
-      delete packet;
-      this->send_tcp_packets.pop();
+      auto pair = this->receive_tcp_packets.front();
+      this->packet_pool.release(pair.second);
+      this->receive_tcp_packets.pop();
     }
     while (!this->receive_udp_packets.empty()) {
       auto packet = this->receive_udp_packets.front();
-      delete packet;
-      this->send_udp_packets.pop();
+      this->packet_pool.release(packet);
+      this->receive_udp_packets.pop();
     }
+    for (auto& link : this->links) link.second.clear(&this->packet_pool);
 
-    NetworkManager::instance = nullptr;
+    if (this->world && this->world->getNetwork() == this)
+      this->world->setNetwork(nullptr);
   }
 
   // ----------------------------------------- //
@@ -218,6 +280,20 @@ class NetworkManager {
 
   virtual bool isHost() const = 0;
 
+  /**
+   * @brief Returns this as Host.
+   *
+   * @return Host* This or nullptr if this is a Client.
+   */
+  virtual Host* asHost() { return nullptr; }
+
+  /**
+   * @brief Returns this as Client.
+   *
+   * @return Client* This or nullptr if this is a Host.
+   */
+  virtual Client* asClient() { return nullptr; }
+
   /**
    * @brief Updates everything.
    *
@@ -225,22 +301,67 @@ class NetworkManager {
   virtual void update() = 0;
 
   /**
-   * @brief Returns the current NetworkManager instance.
+   * @brief Simulates a bad network for all packets received from now on.
+   *
+   * Each connection gets its own LinkSimulator with these conditions.
+   *
+   * @param conditions The conditions; inactive ones turn it off for new
+   * connections.
+   */
+  void simulateLinks(const LinkSimulator::Conditions& conditions) {
+    this->link_conditions = conditions;
+  }
+
+  /**
+   * @brief Opens a file the stats of all connections are appended to every
+   * STATS_INTERVAL, one line of json each (see writeStats()).
    *
-   * This does not create a new instance, if there is no one.
+   * @param file Path of the file.
+   * @return true On success.
+   * @return false If the file can't be opened.
+   */
+  bool setStatsFile(const std::string& file);
+
+  /**
+   * @brief Sets the recorder every handled packet is given to.
    *
-   * @return NetworkManager* Instance
+   * @param recorder The recorder, not owned. nullptr to stop recording.
    */
-  static NetworkManager* getInstance() { return NetworkManager::instance; }
+  void setRecorder(Recorder* recorder) { this->recorder = recorder; }
+
+  /**
+   * @brief Writes the stats of all connections as one line of json.
+   *
+   * @param out The stream to write to.
+   */
+  void writeStats(std::ostream& out) const;
+
+  /**
+   * @brief Returns a vector with strings to add to the log window.
+   *
+   * Contains round trip time, rates and queue of each connection and the
+   * traffic by PacketType of all connections.
+   *
+   * @return Vector with strings to log
+   */
+  std::vector<std::string> getLogText() const;
+
+  /**
+   * @brief Returns the name of a PacketType.
+   *
+   * @param type The PacketType.
+   * @return std::string The name.
+   */
+  static std::string getPacketTypeName(sf::Uint8 type);
 
  protected:
   /**
    * @brief Returns the id of the player.
    *
    * @param player Pointer to the player.
-   * @return uint8_t The players id.
+   * @return uint16_t The players id.
    */
-  virtual uint8_t getPlayerId(const Characters::Player* player) const {
+  virtual uint16_t getPlayerId(const Characters::Player* player) const {
     for (auto pair : this->player_ids)
       if (pair.second == player) return pair.first;
     std::cerr << "Error: Player id not found." << std::endl;
@@ -253,7 +374,7 @@ class NetworkManager {
    * @param id Id of the player.
    * @return Characters::Player* Pointer to the player.
    */
-  virtual Characters::Player* getPlayer(uint8_t id) const {
+  virtual Characters::Player* getPlayer(uint16_t id) const {
     return this->player_ids.at(id);
   }
 
@@ -362,25 +483,85 @@ class NetworkManager {
    * @param id The id of the winner.
    * @param time The time of the winner.
    */
-  void showPlayerWon(sf::Uint8 id, sf::Uint32 time);
+  void showPlayerWon(sf::Uint16 id, sf::Uint32 time);
+
+  /**
+   * @brief Applies an input of a predicted player before simulating a step.
+   *
+   * @param player Pointer to the player.
+   * @param dir The horizontal direction.
+   * @param jump Whether jump is pressed.
+   */
+  void applyPlayerInput(Characters::Player* player, sf::Int8 dir, bool jump);
 
   /**
-   * @brief Sends a packet over tcp.
+   * @brief Sends a packet over tcp without blocking.
    *
    * If the packet can't be sent (satus error or disconnected),
    * it won't be sent.
    *
    * @param socket Pointer to the socket to send on.
    * @param packet Pointer to the packet to send.
-   * @return true Packet was sent successfully.
-   * @return false Packet could not be sent.
+   * @return sf::Socket::Status Done if sent completely. Partial or NotReady
+   * if the socket can't take more data right now: The packet has to be sent
+   * again later to continue. Disconnected or Error if it can't be sent.
    */
-  bool sendTcpPacket(sf::TcpSocket* socket, sf::Packet* packet);
+  sf::Socket::Status sendTcpPacket(sf::TcpSocket* socket, sf::Packet* packet);
+
+  /**
+   * @brief Sends all queued tcp packets.
+   *
+   * Packets of a socket that can't take more data are kept in the queue (in
+   * order) for the next call instead of waiting for the socket.
+   */
+  void sendQueuedTcp();
+
+  /**
+   * @brief Adds a received tcp packet to receive_tcp_packets, through the
+   * simulated link of the connection if link_conditions are active.
+   *
+   * @param link The connection (player id for host, 0 for client).
+   * @param packet The received packet.
+   */
+  void pushReceivedTcp(uint16_t link, sf::Packet* packet);
+
+  /**
+   * @brief Moves packets that arrived on the simulated links to
+   * receive_tcp_packets.
+   *
+   */
+  void receiveLinks();
+
+  /**
+   * @brief Drops all received packets of a connection that aren't handled
+   * yet, also the ones on its simulated link.
+   *
+   * @param link The connection (player id for host, 0 for client).
+   */
+  void dropReceived(uint16_t link);
+
+  /**
+   * @brief Updates the rates of all connections and writes stats_file if
+   * STATS_INTERVAL passed.
+   *
+   */
+  void updateStats();
+
+  /**
+   * @brief Checks whether it's time to send pings again.
+   *
+   * @return true If PING_INTERVAL passed since the last call returning true.
+   * @return false Otherwise.
+   */
+  bool pingDue();
 
   // ----------------------------------------- //
   /* Packet Creation */
   // ----------------------------------------- //
 
+  // All created packets are taken from packet_pool and given back after
+  // sending.
+
   /**
    * @brief Creates a new packet which contains info about a player that wants
    * to be added.
@@ -397,7 +578,7 @@ class NetworkManager {
    * @param position Position of the player.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* playerSetPosPacket(sf::Uint8 id, const sf::Vector2f& position);
+  sf::Packet* playerSetPosPacket(sf::Uint16 id, const sf::Vector2f& position);
 
   /**
    * @brief Creates a new packet which contains the state.
@@ -406,7 +587,7 @@ class NetworkManager {
    * @param new_state State of the player.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* playerChangeStatePacket(sf::Uint8 id,
+  sf::Packet* playerChangeStatePacket(sf::Uint16 id,
                                       Characters::Character::State new_state);
 
   /**
@@ -416,7 +597,7 @@ class NetworkManager {
    * @param dir Direction of the player.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* playerHorizontalDirPacket(sf::Uint8 id, sf::Int8 dir);
+  sf::Packet* playerHorizontalDirPacket(sf::Uint16 id, sf::Int8 dir);
 
   /**
    * @brief Creates a new packet which contains info about the ground.
@@ -434,7 +615,7 @@ class NetworkManager {
    * @param player Pointer to the player.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* addPlayerPacket(sf::Uint8 id, Characters::Player* player);
+  sf::Packet* addPlayerPacket(sf::Uint16 id, Characters::Player* player);
 
   /**
    * @brief Creates a new packet which contains info about the enemy.
@@ -488,7 +669,7 @@ class NetworkManager {
    * @param damage Damge to be taken.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* playerTakeDamagePacket(sf::Uint8 id, sf::Int8 damage);
+  sf::Packet* playerTakeDamagePacket(sf::Uint16 id, sf::Int8 damage);
 
   /**
    * @brief Creates a new packet which contains info about healing a player.
@@ -497,7 +678,7 @@ class NetworkManager {
    * @param new_hp The new hp for the player.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* playerHealPacket(sf::Uint8 id, sf::Int8 new_hp);
+  sf::Packet* playerHealPacket(sf::Uint16 id, sf::Int8 new_hp);
 
   /**
    * @brief Creates a new packet which contains info about a new collectable.
@@ -515,7 +696,7 @@ class NetworkManager {
    * @param player Id of the player who collected it.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* collectableCollectedPacket(sf::Uint32 id, sf::Uint8 player);
+  sf::Packet* collectableCollectedPacket(sf::Uint32 id, sf::Uint16 player);
 
   /**
    * @brief Creates a new packet which contains info about a collectable being
@@ -558,9 +739,12 @@ class NetworkManager {
    *
    * @param distance The distance of the race (see upper right corner of
    * screen).
+   * @param started Whether the race is already running.
+   * @param time The time in ms since the race started.
    * @return sf::Packet* Pointer to the new packet.
    */
-  sf::Packet* setupRacePacket(sf::Uint16 distance);
+  sf::Packet* setupRacePacket(sf::Uint16 distance, bool started,
+                              sf::Uint32 time);
 
   /**
    * @brief Creates a new packet which contains the winner of a race.
@@ -569,7 +753,71 @@ class NetworkManager {
    * @param time The time in ms the winner needed.
    * @return Pointer to the new packet.
    */
-  sf::Packet* declareWinnerPacket(sf::Uint8 id, sf::Uint32 time);
+  sf::Packet* declareWinnerPacket(sf::Uint16 id, sf::Uint32 time);
+
+  /**
+   * @brief Creates a new packet which contains an input of a player.
+   *
+   * @param id The id of the player.
+   * @param sequence The sequence number of the input.
+   * @param dir The horizontal direction.
+   * @param jump Whether jump is pressed.
+   * @return sf::Packet* Pointer to the new packet.
+   */
+  sf::Packet* playerInputPacket(sf::Uint16 id, sf::Uint32 sequence,
+                                sf::Int8 dir, bool jump);
+
+  /**
+   * @brief Creates a new packet which contains the movement state after
+   * applying an input.
+   *
+   * @param sequence The sequence number of the last applied input.
+   * @param move_state The movement state of the player.
+   * @return sf::Packet* Pointer to the new packet.
+   */
+  sf::Packet* playerAckPacket(
+      sf::Uint32 sequence, const Characters::Character::MoveState& move_state);
+
+  /**
+   * @brief Creates a new packet which asks for a Pong.
+   *
+   * @param id The connection id (client's player id).
+   * @param time The current time in ms of stats_clock.
+   * @return sf::Packet* Pointer to the new packet.
+   */
+  sf::Packet* pingPacket(sf::Uint16 id, sf::Uint32 time);
+
+  /**
+   * @brief Creates a new packet which answers a Ping.
+   *
+   * @param id The connection id of the Ping.
+   * @param time The time of the Ping.
+   * @return sf::Packet* Pointer to the new packet.
+   */
+  sf::Packet* pongPacket(sf::Uint16 id, sf::Uint32 time);
+
+  /**
+   * @brief Creates a new packet which contains the state of the world.
+   *
+   * @param grounds The compressed grounds section.
+   * @param grounds_size Size of the grounds section before compression.
+   * @param others The compressed section with all other objects.
+   * @param others_size Size of the other section before compression.
+   * @return sf::Packet* Pointer to the new packet.
+   */
+  sf::Packet* worldStatePacket(const std::vector<uint8_t>& grounds,
+                               sf::Uint32 grounds_size,
+                               const std::vector<uint8_t>& others,
+                               sf::Uint32 others_size);
+
+  /**
+   * @brief Appends a packet to the raw data of a WorldState section and gives
+   * it back to packet_pool.
+   *
+   * @param data The raw section data.
+   * @param packet The packet to append.
+   */
+  void appendToSection(std::vector<uint8_t>* data, sf::Packet* packet);
 
   // ----------------------------------------- //
   /* Received Packet Handling */
@@ -581,6 +829,13 @@ class NetworkManager {
    */
   void handleReceived();
 
+  /**
+   * @brief Performs the needed actions for one packet.
+   *
+   * @param packet The packet, read from the start.
+   */
+  void handlePacket(sf::Packet* packet);
+
   virtual void handleWantAddPlayer(sf::Packet* packet) = 0;
 
   virtual void handleAddPlayer(sf::Packet* packet) = 0;
@@ -624,5 +879,15 @@ class NetworkManager {
   virtual void handleSetupRace(sf::Packet* packet) = 0;
 
   virtual void handleDeclareWinner(sf::Packet* packet) = 0;
+
+  virtual void handlePlayerInput(sf::Packet* packet) = 0;
+
+  virtual void handlePlayerAck(sf::Packet* packet) = 0;
+
+  virtual void handleWorldState(sf::Packet* packet) = 0;
+
+  virtual void handlePing(sf::Packet* packet) = 0;
+
+  virtual void handlePong(sf::Packet* packet) = 0;
 };
 }  // namespace Network
\ No newline at end of file
@@ -0,0 +1,53 @@
+/**
+ * @file packet_pool.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for PacketPool class.
+ * @version 0.1
+ * @date 2020-02-05
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "packet_pool.h"
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~PacketPool() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+PacketPool::~PacketPool() {
+  for (auto packet : this->free_packets) delete packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* acquire() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Packet* PacketPool::acquire() {
+  if (!this->free_packets.empty()) {
+    sf::Packet* packet = this->free_packets.back();
+    this->free_packets.pop_back();
+    return packet;
+  }
+
+  // Reserve buffer (clear() keeps the capacity)
+  static const char zeros[INITIAL_CAPACITY] = {};
+  sf::Packet* packet = new sf::Packet();
+  packet->append(zeros, INITIAL_CAPACITY);
+  packet->clear();
+  return packet;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* release() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void PacketPool::release(sf::Packet* packet) {
+  if (this->free_packets.size() >= MAX_FREE ||
+      packet->getDataSize() > MAX_KEPT_SIZE) {
+    delete packet;
+    return;
+  }
+  packet->clear();
+  this->free_packets.push_back(packet);
+}
+}  // namespace Network
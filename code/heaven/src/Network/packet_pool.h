@@ -0,0 +1,79 @@
+/**
+ * @file packet_pool.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for PacketPool class.
+ * @version 0.1
+ * @date 2020-02-05
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <vector>
+
+namespace Network {
+/** \class PacketPool
+ *  @brief Recycles packets so that their buffers don't have to be allocated
+ * for each message.
+ *
+ * A released packet is cleared, which keeps the capacity of its buffer. New
+ * packets are pre-sized to INITIAL_CAPACITY bytes, which fits every packet
+ * except the big ones sent on joining.
+ */
+class PacketPool {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t INITIAL_CAPACITY =
+      64; /**< Bytes reserved for each new packet */
+
+  static const size_t MAX_FREE = 256; /**< Max packets kept for reuse */
+
+  static const size_t MAX_KEPT_SIZE =
+      4096; /**< Packets with more data are not reused to not keep big
+            buffers */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  std::vector<sf::Packet*> free_packets; /**< Cleared packets ready for use */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Destroys the Packet Pool object and all free packets.
+   *
+   */
+  ~PacketPool();
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Returns an empty packet.
+   *
+   * @return sf::Packet* Pointer to the packet. Must be given back with
+   * release().
+   */
+  sf::Packet* acquire();
+
+  /**
+   * @brief Gives a packet back to the pool.
+   *
+   * @param packet Pointer to the packet, which must not be used afterwards.
+   */
+  void release(sf::Packet* packet);
+};
+}  // namespace Network
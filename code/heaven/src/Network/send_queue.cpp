@@ -0,0 +1,101 @@
+/**
+ * @file send_queue.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for SendQueue class.
+ * @version 0.1
+ * @date 2020-02-06
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "send_queue.h"
+
+#include <iostream>
+
+#include "../trace.h"
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* push() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void SendQueue::push(sf::Packet* packet, sf::Uint64 key, PacketPool* pool) {
+  // Size is sent as Uint32 in front of the data
+  size_t size = packet->getDataSize() + sizeof(sf::Uint32);
+
+  if (key != NO_MERGE) {
+    // Replace queued packet with same key (except a partially sent one)
+    for (size_t i = this->front_started ? 1 : 0; i < this->entries.size();
+         i++) {
+      Entry& entry = this->entries[i];
+      if (entry.key != key) continue;
+      this->bytes = this->bytes - entry.size + size;
+      pool->release(entry.packet);
+      entry.packet = packet;
+      entry.size = size;
+      return;
+    }
+  }
+
+  if (this->entries.empty()) this->progress_clock.restart();
+  Entry entry;
+  entry.packet = packet;
+  entry.key = key;
+  entry.size = size;
+  this->entries.push_back(entry);
+  this->bytes += size;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* flush() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Socket::Status SendQueue::flush(sf::TcpSocket* socket, PacketPool* pool,
+                                    ConnectionStats* stats) {
+  while (!this->entries.empty()) {
+    Entry& entry = this->entries.front();
+    sf::Socket::Status status = socket->send(*entry.packet);
+    switch (status) {
+      case sf::Socket::Status::Partial:
+        // Continued on next flush
+        this->front_started = true;
+        this->progress_clock.restart();
+        return status;
+
+      case sf::Socket::Status::NotReady:
+      case sf::Socket::Status::Disconnected:
+        return status;
+
+      case sf::Socket::Status::Error:
+        std::cerr << "Error while sending tcp packet: Code " << status
+                  << " Error." << std::endl;
+        // Fall through to drop packet
+
+      case sf::Socket::Status::Done:
+        if (status == sf::Socket::Status::Done) {
+          if (stats) stats->countSent(*entry.packet);
+          Trace::instant("send", "network", "bytes",
+                         entry.packet->getDataSize(), "type",
+                         ConnectionStats::getType(*entry.packet));
+        }
+        this->bytes -= entry.size;
+        pool->release(entry.packet);
+        this->entries.pop_front();
+        this->front_started = false;
+        this->progress_clock.restart();
+        break;
+    }
+  }
+  return sf::Socket::Status::Done;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* clear() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void SendQueue::clear(PacketPool* pool) {
+  for (auto& entry : this->entries) pool->release(entry.packet);
+  this->entries.clear();
+  this->bytes = 0;
+  this->front_started = false;
+}
+}  // namespace Network
@@ -0,0 +1,114 @@
+/**
+ * @file send_queue.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for SendQueue class.
+ * @version 0.1
+ * @date 2020-02-06
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <deque>
+
+#include "connection_stats.h"
+#include "packet_pool.h"
+
+namespace Network {
+/** \class SendQueue
+ *  @brief Outgoing packets of one connection.
+ *
+ * Packets are sent without blocking. If the socket can't take more data, the
+ * rest is sent on the next flush(), continuing a partially sent packet. A
+ * packet pushed with a merge key replaces a queued one with the same key
+ * (e.g. an older position of the same entity) instead of being appended.
+ */
+class SendQueue {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const sf::Uint64 NO_MERGE = 0; /**< Key of packets never merged */
+
+  /**
+   * @brief A queued packet.
+   */
+  struct Entry {
+    sf::Packet* packet; /**< The packet */
+    sf::Uint64 key;     /**< Merge key or NO_MERGE */
+    size_t size;        /**< Bytes sent for this packet */
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  std::deque<Entry> entries; /**< Queued packets, oldest first */
+  size_t bytes = 0;          /**< Bytes of all queued packets */
+  bool front_started =
+      false; /**< Whether the first packet is partially sent */
+  sf::Clock progress_clock; /**< Time since data was sent last or the queue
+                            was empty */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Queues a packet.
+   *
+   * @param packet Pointer to the packet (from pool).
+   * @param key Merge key or NO_MERGE.
+   * @param pool The pool to give a replaced packet back to.
+   */
+  void push(sf::Packet* packet, sf::Uint64 key, PacketPool* pool);
+
+  /**
+   * @brief Sends as much as the socket takes without blocking.
+   *
+   * Sent packets are given back to the pool. Packets that can't be sent
+   * because of an error are dropped.
+   *
+   * @param socket The socket to send on.
+   * @param pool The pool to give sent packets back to.
+   * @param stats Counts the sent packets if not nullptr.
+   * @return sf::Socket::Status Done if the queue is empty now, Disconnected if
+   * the socket is disconnected, otherwise NotReady or Partial.
+   */
+  sf::Socket::Status flush(sf::TcpSocket* socket, PacketPool* pool,
+                           ConnectionStats* stats = nullptr);
+
+  /**
+   * @brief Removes all packets.
+   *
+   * @param pool The pool to give the packets back to.
+   */
+  void clear(PacketPool* pool);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  size_t getBytes() const { return this->bytes; }
+
+  size_t size() const { return this->entries.size(); }
+
+  /**
+   * @brief Returns how long the queue waits for the socket.
+   *
+   * @return sf::Int32 Time in ms since data was sent last or 0 if the queue
+   * is empty.
+   */
+  sf::Int32 getStallTime() const {
+    if (this->entries.empty()) return 0;
+    return this->progress_clock.getElapsedTime().asMilliseconds();
+  }
+};
+}  // namespace Network
@@ -0,0 +1,80 @@
+/**
+ * @file snapshot_buffer.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for SnapshotBuffer class.
+ * @version 0.1
+ * @date 2020-02-03
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "snapshot_buffer.h"
+
+namespace Network {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* push() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void SnapshotBuffer::push(sf::Int32 time, const sf::Vector2f& position) {
+  if (!this->snapshots.empty()) {
+    float delta = (float)(time - this->snapshots.back().first);
+    if (this->interval == 0) {
+      this->interval = delta;
+    } else {
+      // Smooth like tcp rtt estimation
+      float deviation = delta - this->interval;
+      this->jitter += ((deviation < 0 ? -deviation : deviation) -
+                       this->jitter) / 16.f;
+      this->interval += deviation / 8.f;
+    }
+  }
+
+  this->snapshots.push_back(
+      std::pair<sf::Int32, sf::Vector2f>(time, position));
+  while (this->snapshots.size() > MAX_SNAPSHOTS) this->snapshots.pop_front();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* sample() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Vector2f SnapshotBuffer::sample(sf::Int32 time) const {
+  sf::Int32 render_time = time - getDelay();
+
+  // Too old
+  if (render_time <= this->snapshots.front().first)
+    return this->snapshots.front().second;
+
+  // Interpolate
+  for (size_t i = 1; i < this->snapshots.size(); i++) {
+    const std::pair<sf::Int32, sf::Vector2f>& from = this->snapshots[i - 1];
+    const std::pair<sf::Int32, sf::Vector2f>& to = this->snapshots[i];
+    if (render_time < to.first) {
+      float t =
+          (float)(render_time - from.first) / (float)(to.first - from.first);
+      return from.second + (to.second - from.second) * t;
+    }
+  }
+
+  // Extrapolate
+  const std::pair<sf::Int32, sf::Vector2f>& last = this->snapshots.back();
+  if (this->snapshots.size() < 2) return last.second;
+  const std::pair<sf::Int32, sf::Vector2f>& prev =
+      this->snapshots[this->snapshots.size() - 2];
+  if (last.first == prev.first) return last.second;
+  sf::Int32 ahead = render_time - last.first;
+  if (ahead > MAX_EXTRAPOLATION) ahead = MAX_EXTRAPOLATION;
+  return last.second + (last.second - prev.second) *
+                           ((float)ahead / (float)(last.first - prev.first));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getDelay() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Int32 SnapshotBuffer::getDelay() const {
+  sf::Int32 delay = (sf::Int32)(this->interval + 2 * this->jitter);
+  if (delay < MIN_DELAY) return MIN_DELAY;
+  if (delay > MAX_DELAY) return MAX_DELAY;
+  return delay;
+}
+}  // namespace Network
@@ -0,0 +1,87 @@
+/**
+ * @file snapshot_buffer.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for SnapshotBuffer class.
+ * @version 0.1
+ * @date 2020-02-03
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+#include <deque>
+
+namespace Network {
+/** \class SnapshotBuffer
+ *  @brief Buffers received positions of one remote entity.
+ *
+ * The position is shown a small delay behind the newest snapshot and
+ * interpolated between the two snapshots around that time. The delay adapts
+ * to the interval and jitter of the received snapshots. If no snapshot
+ * arrived in time, the position is extrapolated for at most
+ * MAX_EXTRAPOLATION ms.
+ */
+class SnapshotBuffer {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t MAX_SNAPSHOTS = 32; /**< Max snapshots kept */
+
+  static const sf::Int32 MIN_DELAY = 10, /**< Min delay in ms */
+      MAX_DELAY = 250,                   /**< Max delay in ms */
+      MAX_EXTRAPOLATION = 100; /**< Max time in ms to extrapolate */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  std::deque<std::pair<sf::Int32, sf::Vector2f>>
+      snapshots; /**< Receive time in ms with position, oldest first */
+
+  float interval = 0, /**< Smoothed time in ms between two snapshots */
+      jitter = 0;     /**< Smoothed deviation of interval in ms */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Adds a new snapshot.
+   *
+   * @param time The time in ms the snapshot was received.
+   * @param position The received position.
+   */
+  void push(sf::Int32 time, const sf::Vector2f& position);
+
+  /**
+   * @brief Calculates the position to show.
+   *
+   * Must not be called if this buffer is empty.
+   *
+   * @param time The current time in ms.
+   * @return sf::Vector2f The interpolated or extrapolated position.
+   */
+  sf::Vector2f sample(sf::Int32 time) const;
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  bool empty() const { return this->snapshots.empty(); }
+
+  /**
+   * @brief Returns the current delay.
+   *
+   * @return sf::Int32 The delay in ms behind the current time.
+   */
+  sf::Int32 getDelay() const;
+};
+}  // namespace Network
@@ -0,0 +1,106 @@
+/**
+ * @file alloc_tracker.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for AllocTracker class and the global operator new and
+ * delete.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "alloc_tracker.h"
+
+#include <cstdlib>
+#include <new>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Static Variables */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Plain thread locals (no constructor), safe to use inside operator new
+static thread_local uint8_t current_tag = 0;
+static thread_local AllocTracker::Counter counters[AllocTracker::MAX_TAGS];
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setTag() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+uint8_t AllocTracker::setTag(uint8_t tag) {
+  uint8_t previous = current_tag;
+  current_tag = tag < MAX_TAGS ? tag : 0;
+  return previous;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* get() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+AllocTracker::Counter AllocTracker::get(uint8_t tag) {
+  if (tag >= MAX_TAGS) return Counter();
+  return counters[tag];
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* total() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+AllocTracker::Counter AllocTracker::total() {
+  Counter sum;
+  for (size_t i = 0; i < MAX_TAGS; i++) {
+    sum.allocations += counters[i].allocations;
+    sum.frees += counters[i].frees;
+    sum.bytes += counters[i].bytes;
+  }
+  return sum;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* countAllocation() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void AllocTracker::countAllocation(size_t bytes) {
+  Counter& counter = counters[current_tag];
+  counter.allocations++;
+  counter.bytes += bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* countFree() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void AllocTracker::countFree() { counters[current_tag].frees++; }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* operator new / delete */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void* operator new(std::size_t size) {
+  AllocTracker::countAllocation(size);
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+  if (!pointer) throw std::bad_alloc();
+  return pointer;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  AllocTracker::countAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept {
+  if (!pointer) return;
+  AllocTracker::countFree();
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  operator delete(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  operator delete(pointer);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file alloc_tracker.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for AllocTracker class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+
+/** \class AllocTracker
+ *  @brief Counts heap allocations by tag.
+ *
+ * The global operator new and delete are replaced (alloc_tracker.cpp) to count
+ * every allocation of the calling thread under its current tag. Profiler::Scope
+ * sets the tag to its phase, so allocations are counted in the innermost
+ * phase. Counters are per thread and never reset; take the difference of two
+ * reads.
+ */
+class AllocTracker {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t MAX_TAGS = 32; /**< Max number of tags */
+
+  /**
+   * @brief Allocations of one tag.
+   */
+  struct Counter {
+    sf::Uint64 allocations = 0, /**< Calls of operator new */
+        frees = 0,              /**< Calls of operator delete */
+        bytes = 0;              /**< Allocated bytes */
+
+    Counter operator-(const Counter& other) const {
+      Counter result;
+      result.allocations = allocations - other.allocations;
+      result.frees = frees - other.frees;
+      result.bytes = bytes - other.bytes;
+      return result;
+    }
+  };
+
+  /**
+   * @brief Sets the tag from construction to destruction.
+   */
+  class Tag {
+   private:
+    uint8_t previous; /**< Tag before construction */
+
+   public:
+    Tag(uint8_t tag) : previous(AllocTracker::setTag(tag)) {}
+    ~Tag() { AllocTracker::setTag(this->previous); }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief Sets the tag of the calling thread.
+   *
+   * @param tag The new tag, less than MAX_TAGS.
+   * @return uint8_t The previous tag.
+   */
+  static uint8_t setTag(uint8_t tag);
+
+  /**
+   * @brief Returns the counter of a tag of the calling thread.
+   *
+   * @param tag The tag.
+   * @return Counter The counter.
+   */
+  static Counter get(uint8_t tag);
+
+  /**
+   * @brief Returns the sum of all counters of the calling thread.
+   *
+   * @return Counter The sum.
+   */
+  static Counter total();
+
+  /**
+   * @brief Counts an allocation. Called by operator new.
+   *
+   * @param bytes The allocated bytes.
+   */
+  static void countAllocation(size_t bytes);
+
+  /**
+   * @brief Counts a free. Called by operator delete.
+   *
+   */
+  static void countFree();
+};
@@ -0,0 +1,106 @@
+/**
+ * @file component_table.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for ComponentTable class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+/** \class ComponentTable
+ *  @brief Dense copy of the bounds of a list of entities.
+ *
+ * Grounds, Characters and Collectables are polymorphic objects spread over
+ * the heap, so every getGlobalBounds() in a loop is a virtual call into a
+ * different cache line (and for sprites a transform). A table copies the
+ * bounds once into a contiguous array, index i belongs to entities[i], so
+ * loops that only need the position (collision, pickup, culling) run
+ * linearly over it and only touch the entity for hits.
+ *
+ * The table does not own the entities and does not notice changes, it must
+ * be synced with the source vector before it is used after anything could
+ * have moved, added or removed an entity.
+ *
+ * T must have getGlobalBounds().
+ */
+template <typename T>
+class ComponentTable {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  std::vector<T*> entities;          /**< The entities, same order as source */
+  std::vector<sf::FloatRect> bounds; /**< Global bounds of entities[i] */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Copies the entities and their current bounds.
+   *
+   * Keeps the capacity, so syncing every tick doesn't allocate.
+   *
+   * @param source The entities.
+   */
+  void sync(const std::vector<T*>& source) {
+    this->entities.assign(source.begin(), source.end());
+    this->bounds.resize(source.size());
+    for (size_t i = 0; i < source.size(); i++)
+      this->bounds[i] = source[i]->getGlobalBounds();
+  }
+
+  /**
+   * @brief Copies the entities with their current bounds for which filter
+   * returns true.
+   *
+   * @param source The entities.
+   * @param filter Called with an entity and its bounds.
+   */
+  template <typename F>
+  void sync(const std::vector<T*>& source, F filter) {
+    clear();
+    for (auto entity : source) {
+      sf::FloatRect entity_bounds = entity->getGlobalBounds();
+      if (!filter(entity, entity_bounds)) continue;
+      this->entities.push_back(entity);
+      this->bounds.push_back(entity_bounds);
+    }
+  }
+
+  /**
+   * @brief Removes entry i, keeping the order.
+   *
+   * @param i The index.
+   */
+  void erase(size_t i) {
+    this->entities.erase(this->entities.begin() + i);
+    this->bounds.erase(this->bounds.begin() + i);
+  }
+
+  /**
+   * @brief Removes all entries (keeps the capacity).
+   *
+   */
+  void clear() {
+    this->entities.clear();
+    this->bounds.clear();
+  }
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  size_t size() const { return this->entities.size(); }
+};
@@ -0,0 +1,96 @@
+/**
+ * @file frame_arena.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for FrameArena class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "frame_arena.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* FrameArena() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+FrameArena::FrameArena(size_t size) {
+  Block block;
+  block.size = size;
+  block.data = new char[size];
+  this->blocks.reserve(8);
+  this->blocks.push_back(block);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~FrameArena() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+FrameArena::~FrameArena() {
+  for (Block& block : this->blocks) delete[] block.data;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* allocate() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+  Block* block = &this->blocks.back();
+  size_t offset = (this->used + alignment - 1) & ~(alignment - 1);
+  if (offset + bytes > block->size) {
+    // Next block, at least twice as big
+    Block next;
+    next.size = block->size * 2;
+    while (next.size < bytes + alignment) next.size *= 2;
+    next.data = new char[next.size];
+    this->blocks.push_back(next);
+    block = &this->blocks.back();
+    offset = 0;
+  }
+
+  this->last = block->data + offset;
+  this->used = offset + bytes;
+  this->frame_bytes += bytes;
+  return this->last;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* deallocate() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void FrameArena::deallocate(void* pointer, size_t bytes) {
+  if (pointer == nullptr || pointer != this->last) return;
+  // Newest allocation: give it back
+  this->used = this->last - this->blocks.back().data;
+  this->frame_bytes -= bytes;
+  this->last = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* reset() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void FrameArena::reset() {
+  if (this->blocks.size() > 1) {
+    // Replace by one block for the whole frame
+    Block block;
+    block.size = 0;
+    for (Block& old : this->blocks) {
+      block.size += old.size;
+      delete[] old.data;
+    }
+    block.data = new char[block.size];
+    this->blocks.clear();
+    this->blocks.push_back(block);
+  }
+
+  if (this->frame_bytes > this->peak_bytes)
+    this->peak_bytes = this->frame_bytes;
+  this->frame_bytes = 0;
+  this->used = 0;
+  this->last = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* get() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+FrameArena& FrameArena::get() {
+  static thread_local FrameArena arena;
+  return arena;
+}
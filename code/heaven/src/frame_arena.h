@@ -0,0 +1,164 @@
+/**
+ * @file frame_arena.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for FrameArena class and FrameAllocator.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+/** \class FrameArena
+ *  @brief Linear allocator for data that only lives until the end of a frame.
+ *
+ * Memory is taken from the current block by moving an offset forward. Freeing
+ * does nothing, except for the newest allocation (so a growing vector can
+ * reuse its space). reset() at the end of a frame releases everything at
+ * once. If a frame needed more than one block, they are replaced by one block
+ * big enough for the whole frame, so later frames don't allocate at all.
+ *
+ * Every thread has its own arena (see get()). The loop that calls
+ * World::update() must call reset() after each frame, nothing allocated in it
+ * may be kept longer.
+ */
+class FrameArena {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const size_t BLOCK_SIZE = 64 * 1024; /**< Size of the first block */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  /**
+   * @brief One chunk of memory.
+   */
+  struct Block {
+    char* data;  /**< The memory */
+    size_t size; /**< Size of data */
+  };
+
+  std::vector<Block> blocks; /**< All blocks, the last one is in use */
+  size_t used = 0;           /**< Used bytes of the last block */
+  size_t frame_bytes = 0;    /**< Bytes allocated in this frame */
+  size_t peak_bytes = 0;     /**< Max bytes allocated in one frame */
+  char* last = nullptr;      /**< Start of the newest allocation */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new Frame Arena object.
+   *
+   * @param size Size of the first block.
+   */
+  FrameArena(size_t size = BLOCK_SIZE);
+
+  /**
+   * @brief Destroys the Frame Arena object and frees all blocks.
+   *
+   */
+  ~FrameArena();
+
+  FrameArena(const FrameArena&) = delete;
+  FrameArena& operator=(const FrameArena&) = delete;
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Allocates memory until the next reset().
+   *
+   * @param bytes Number of bytes.
+   * @param alignment Alignment, a power of 2.
+   * @return void* The memory.
+   */
+  void* allocate(size_t bytes, size_t alignment);
+
+  /**
+   * @brief Frees memory. Only the newest allocation is actually given back.
+   *
+   * @param pointer The memory.
+   * @param bytes Number of bytes.
+   */
+  void deallocate(void* pointer, size_t bytes);
+
+  /**
+   * @brief Releases everything allocated since the last reset.
+   *
+   */
+  void reset();
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Returns the arena of the calling thread.
+   *
+   * @return FrameArena& The arena.
+   */
+  static FrameArena& get();
+
+  size_t getFrameBytes() const { return this->frame_bytes; }
+
+  size_t getPeakBytes() const { return this->peak_bytes; }
+};
+
+/** \class FrameAllocator
+ *  @brief STL allocator using the FrameArena of the calling thread.
+ *
+ * Containers using it must not outlive the current frame.
+ */
+template <typename T>
+class FrameAllocator {
+ public:
+  typedef T value_type;
+
+  FrameAllocator() {}
+
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return (T*)FrameArena::get().allocate(n * sizeof(T), alignof(T));
+  }
+
+  void deallocate(T* pointer, size_t n) {
+    FrameArena::get().deallocate(pointer, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const FrameAllocator<U>&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const FrameAllocator<U>&) const {
+    return false;
+  }
+};
+
+/** Vector for data of the current frame */
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+/** String for text of the current frame */
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>
+    FrameString;
@@ -0,0 +1,198 @@
+/**
+ * @file job_system.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for JobSystem class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "job_system.h"
+
+#include "frame_arena.h"
+#include "trace.h"
+
+// Effects of the item the calling thread is running, nullptr outside of one
+static thread_local std::vector<std::function<void()>>* item_effects = nullptr;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* JobSystem() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+JobSystem::JobSystem(unsigned int threads) { setThreads(threads); }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~JobSystem() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+JobSystem::~JobSystem() { stopWorkers(); }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* run() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void JobSystem::run(size_t count, const void* function,
+                    void (*call)(const void*, size_t)) {
+  if (count == 0) return;
+
+  // Nested: the outer item collects the effects
+  if (item_effects) {
+    for (size_t i = 0; i < count; i++) call(function, i);
+    return;
+  }
+
+  // Only the effects vectors that are used are cleared, keep the capacity
+  if (this->effects.size() < count) this->effects.resize(count);
+
+  // Deal out the jobs, job j goes to thread j % threads
+  size_t jobs = this->threads * JOBS_PER_THREAD;
+  if (jobs > count) jobs = count;
+  size_t per_job = (count + jobs - 1) / jobs;
+  jobs = (count + per_job - 1) / per_job;
+
+  // Before the first job is queued, a worker may still be looking for one
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->pending = jobs;
+  }
+  for (size_t j = 0; j < jobs; j++) {
+    Job job;
+    job.function = function;
+    job.call = call;
+    job.begin = j * per_job;
+    job.end = job.begin + per_job < count ? job.begin + per_job : count;
+    Queue& queue = this->queues[j % this->threads];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.jobs.push_back(job);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->generation++;
+  }
+  if (this->threads > 1) this->wake.notify_all();
+
+  // Help until nothing is left, then wait for the jobs of the workers
+  while (runJob(0)) {
+  }
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->done.wait(lock, [this]() { return this->pending == 0; });
+  }
+
+  // Merge the effects in order of the items
+  for (size_t i = 0; i < count; i++) {
+    for (auto& effect : this->effects[i]) effect();
+    this->effects[i].clear();
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* defer() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void JobSystem::defer(const std::function<void()>& effect) {
+  if (item_effects)
+    item_effects->push_back(effect);
+  else
+    effect();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* isInJob() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool JobSystem::isInJob() { return item_effects != nullptr; }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setThreads() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void JobSystem::setThreads(unsigned int threads) {
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;  // Unknown
+  if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+  stopWorkers();
+  this->threads = threads;
+  this->queues.clear();
+  for (unsigned int i = 0; i < threads; i++) this->queues.emplace_back();
+  for (unsigned int i = 1; i < threads; i++)
+    this->workers.push_back(std::thread(&JobSystem::work, this, i));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* work() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void JobSystem::work(unsigned int index) {
+  sf::Uint64 seen = 0;
+  Trace* named_in = nullptr;  // The trace may start after the workers
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->wake.wait(lock, [this, seen]() {
+        return this->quit || this->generation != seen;
+      });
+      if (this->quit) return;
+      seen = this->generation;
+    }
+    if (Trace::getInstance() != named_in) {
+      named_in = Trace::getInstance();
+      Trace::setThreadName("worker " + std::to_string(index));
+    }
+    while (runJob(index)) {
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* runJob() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool JobSystem::runJob(unsigned int index) {
+  Job job;
+  bool found = false;
+
+  // Own queue from the back, the others from the front
+  for (unsigned int i = 0; i < this->threads && !found; i++) {
+    Queue& queue = this->queues[(index + i) % this->threads];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.front == queue.jobs.size()) continue;
+    if (i == 0) {
+      job = queue.jobs.back();
+      queue.jobs.pop_back();
+    } else {
+      job = queue.jobs[queue.front++];
+    }
+    if (queue.front == queue.jobs.size()) {
+      queue.jobs.clear();
+      queue.front = 0;
+    }
+    found = true;
+  }
+  if (!found) return false;
+
+  {
+    Trace::Scope scope("Job", "jobs");
+    for (size_t i = job.begin; i < job.end; i++) {
+      item_effects = &this->effects[i];
+      job.call(job.function, i);
+    }
+    item_effects = nullptr;
+  }
+  // The caller resets its own arena after the frame
+  if (index > 0) FrameArena::get().reset();
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (--this->pending == 0) this->done.notify_one();
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* stopWorkers() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void JobSystem::stopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->quit = true;
+  }
+  this->wake.notify_all();
+  for (auto& worker : this->workers) worker.join();
+  this->workers.clear();
+  this->quit = false;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file job_system.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for JobSystem class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** \class JobSystem
+ *  @brief Runs the items of a loop on several threads (work stealing).
+ *
+ * parallelFor() splits the items into jobs and deals them out to the queues
+ * of all threads, the calling thread is one of them. A thread takes jobs from
+ * the back of its own queue and, if that is empty, steals from the front of
+ * the others, so no thread idles while another has a long list.
+ *
+ * Items may only change their own object. Anything else (other objects,
+ * timers, the network) has to go through defer(): the effects are collected
+ * per item and run by the calling thread after all items are done, in order
+ * of the items. So the result is the same for any number of threads,
+ * including 1 (no worker threads at all).
+ *
+ * Worker threads reset their FrameArena after each job, memory of it must
+ * not be kept longer than the job.
+ */
+class JobSystem {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const unsigned int MAX_THREADS = 64; /**< Max threads incl. caller */
+
+  static const size_t JOBS_PER_THREAD =
+      4; /**< Jobs per thread a loop is split into, so there is something left
+            to steal */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  /**
+   * @brief A range of items of the current loop.
+   */
+  struct Job {
+    const void* function;               /**< Called for each item */
+    void (*call)(const void*, size_t);  /**< Calls function with an item */
+    size_t begin,                       /**< First item */
+        end;                            /**< Item after the last */
+  };
+
+  /**
+   * @brief The jobs of one thread.
+   */
+  struct Queue {
+    std::mutex mutex;      /**< Locks jobs and front */
+    std::vector<Job> jobs; /**< Own jobs at the back, stolen at the front;
+                           cleared when empty, so the capacity is kept */
+    size_t front = 0;      /**< Index of the first job not stolen */
+  };
+
+  unsigned int threads = 1;            /**< Threads incl. the caller */
+  std::vector<std::thread> workers;    /**< Worker threads */
+  std::deque<Queue> queues;            /**< One per thread, 0 is the caller */
+  std::vector<std::vector<std::function<void()>>>
+      effects; /**< Deferred effects of each item of the current loop */
+
+  std::mutex mutex;              /**< Locks generation, pending and quit */
+  std::condition_variable wake;  /**< Notifies workers of a new loop */
+  std::condition_variable done;  /**< Notifies the caller of the last job */
+  sf::Uint64 generation = 0;     /**< Number of started loops */
+  size_t pending = 0;            /**< Jobs of the current loop not done */
+  bool quit = false;             /**< Tells the workers to stop */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new Job System object.
+   *
+   * @param threads See setThreads().
+   */
+  JobSystem(unsigned int threads = 1);
+
+  /**
+   * @brief Destroys the Job System object and joins the workers.
+   *
+   */
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Calls function for each item from 0 to count - 1 and returns when
+   * all are done. The deferred effects are run afterwards, in order of the
+   * items.
+   *
+   * Inside of an item (nested) the items are run directly by the calling
+   * thread and their effects belong to the outer item.
+   *
+   * A template, so a lambda capturing more than a few references isn't
+   * copied into a std::function (which allocates) on every call.
+   *
+   * @tparam Function Callable with a size_t.
+   * @param count Number of items.
+   * @param function Called with the index of an item.
+   */
+  template <typename Function>
+  void parallelFor(size_t count, const Function& function) {
+    run(count, &function,
+        [](const void* f, size_t i) { (*(const Function*)f)(i); });
+  }
+
+  /**
+   * @brief Runs an effect of an item after the loop, or directly if not
+   * called inside of parallelFor().
+   *
+   * @param effect The effect.
+   */
+  static void defer(const std::function<void()>& effect);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Returns whether the calling thread is running an item.
+   *
+   * @return true If effects are deferred.
+   */
+  static bool isInJob();
+
+  /**
+   * @brief Sets the number of threads, the calling thread included. Must not
+   * be called inside of parallelFor().
+   *
+   * @param threads 1 for no workers, 0 for one thread per core.
+   */
+  void setThreads(unsigned int threads);
+
+  unsigned int getThreads() const { return this->threads; }
+
+  // ----------------------------------------- //
+  /* Private Methods */
+  // ----------------------------------------- //
+ private:
+  /**
+   * @brief Implements parallelFor() for any callable.
+   *
+   * @param count Number of items.
+   * @param function The callable.
+   * @param call Calls function with the index of an item.
+   */
+  void run(size_t count, const void* function,
+           void (*call)(const void*, size_t));
+
+  /**
+   * @brief Main loop of a worker thread.
+   *
+   * @param index The index of its queue.
+   */
+  void work(unsigned int index);
+
+  /**
+   * @brief Runs one job from the own queue or stolen from another one.
+   *
+   * @param index The index of the own queue.
+   * @return true If a job was run.
+   */
+  bool runJob(unsigned int index);
+
+  /**
+   * @brief Stops and joins all workers.
+   *
+   */
+  void stopWorkers();
+};
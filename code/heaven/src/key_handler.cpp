@@ -55,6 +55,13 @@ bool KeyHandler::keyPressed(sf::Event& event, float factor) {
       this->right_pressed = true;
       break;
 
+    case Grounds::Button::INTERACT_KEY:
+      // ----------------------------------------- //
+      /* Press Buttons */
+      // ----------------------------------------- //
+      this->player->setInteracting(true);
+      break;
+
     case sf::Keyboard::F6:  // Open editor
       std::cout << "Editor closed. Code: " << startEditor(nullptr) << std::endl;
       return false;
@@ -64,6 +71,14 @@ bool KeyHandler::keyPressed(sf::Event& event, float factor) {
       this->show_help = true;
       break;
 
+    case ProfilerOverlay::PROFILER_KEY:
+      this->show_profiler = !this->show_profiler;
+      break;
+
+    case Trace::TRACE_KEY:
+      if (Trace::getInstance()) Trace::getInstance()->toggle();
+      break;
+
     default:
       // ----------------------------------------- //
       /* Default */
@@ -107,6 +122,13 @@ void KeyHandler::keyReleased(sf::Event& event, float factor) {
       this->player->setHorizontalMovement(0);
       break;
 
+    case Grounds::Button::INTERACT_KEY:
+      // ----------------------------------------- //
+      /* Stop Pressing Buttons */
+      // ----------------------------------------- //
+      this->player->setInteracting(false);
+      break;
+
     case HelpOverlay::HELP_KEY:
       this->show_help = false;
       break;
@@ -13,8 +13,11 @@
 
 #include "Characters/player.h"
 #include "Editor/editor.h"
+#include "Grounds/Buttons/button.h"
 #include "SFML/Window.hpp"
 #include "help_overlay.h"
+#include "profiler_overlay.h"
+#include "trace.h"
 #include "world.h"
 
 /** \class KeyHandler
@@ -33,6 +36,8 @@ class KeyHandler {
 
   bool show_help = false;
 
+  bool show_profiler = false; /**< Toggled by PROFILER_KEY */
+
   sf::RenderWindow* window;   /**< The window used */
   Characters::Player* player; /**< The player being controlled */
   World* world;               /**< The world being controlled */
@@ -80,6 +85,8 @@ class KeyHandler {
 
   bool showHelp() { return this->show_help; }
 
+  bool showProfiler() { return this->show_profiler; }
+
   /**
    * @brief Ends this window and starts the editor.
    *
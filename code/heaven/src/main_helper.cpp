@@ -11,6 +11,8 @@
 
 #include "main_helper.h"
 
+#include <iostream>
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* createWindow() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -81,4 +83,42 @@ std::map<std::string, char*> MainHelper::parseArgs(int argc, char** argv) {
     args[std::string(opt)] = opt + strip_index + 1;
   }
   return args;
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* parseNetsim() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Network::LinkSimulator::Conditions MainHelper::parseNetsim(
+    std::map<std::string, char*>& args) {
+  Network::LinkSimulator::Conditions conditions;
+  if (args.count("netsim") == 0) return conditions;
+  if (!Network::LinkSimulator::parse(args["netsim"], &conditions)) {
+    std::cerr << "Error: Invalid netsim option, expected e.g. "
+                 "netsim=delay=80,jitter=20,dist=normal,loss=0.01,"
+                 "reorder=0,bandwidth=64000,seed=1"
+              << std::endl;
+    exit(1);
+  }
+  return conditions;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* numberArg() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+long MainHelper::numberArg(std::map<std::string, char*>& args,
+                           const std::string& key, long value, long min,
+                           long max) {
+  if (args.count(key) == 0) return value;
+  try {
+    value = std::stol(args[key]);
+  } catch (const std::exception&) {
+    std::cerr << "Error: " << key << " must be a number." << std::endl;
+    exit(1);
+  }
+  if (value < min || value > max) {
+    std::cerr << "Error: " << key << " must be between " << min << " and "
+              << max << "." << std::endl;
+    exit(1);
+  }
+  return value;
+}
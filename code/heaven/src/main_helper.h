@@ -17,6 +17,7 @@
 
 
 #include "SFML/Graphics.hpp"
+#include "Network/link_simulator.h"
 
 /**
  * @brief Contains constants and functions directly for the main file and
@@ -60,4 +61,32 @@ sf::Texture loadBackgroundTexture();
  * value option value.
  */
 std::map<std::string, char*> parseArgs(int argc, char** argv);
+
+/**
+ * @brief Reads the conditions of the network simulation from the netsim
+ * option (see Network::LinkSimulator::parse()).
+ *
+ * Exits if the option is invalid.
+ *
+ * @param args The parsed args.
+ * @return Network::LinkSimulator::Conditions The conditions; inactive if the
+ * option is missing.
+ */
+Network::LinkSimulator::Conditions parseNetsim(
+    std::map<std::string, char*>& args);
+
+/**
+ * @brief Reads a number from the args.
+ *
+ * Exits if the value is not a number between min and max.
+ *
+ * @param args The parsed args.
+ * @param key The name of the option.
+ * @param value The default value, returned if the option is missing.
+ * @param min The min value.
+ * @param max The max value.
+ * @return long The value.
+ */
+long numberArg(std::map<std::string, char*>& args, const std::string& key,
+               long value, long min, long max);
 }  // namespace MainHelper
\ No newline at end of file
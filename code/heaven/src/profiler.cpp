@@ -0,0 +1,224 @@
+/**
+ * @file profiler.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for Profiler class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+#include "trace.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Static Variables */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+thread_local Profiler* Profiler::instance = nullptr;
+
+const char* const Profiler::NAMES[Profiler::PHASES] = {
+    "Frame",         "Sleep",          "Events",
+    "Update",        "Update/Scenes",  "Update/Collectables",
+    "Update/Enemies", "Update/Players", "Update/Contacts",
+    "Network",       "Draw",           "HUD",
+    "Display"};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Scope() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Profiler::Scope::Scope(Phase phase)
+    : phase(phase),
+      start(Profiler::instance ? Profiler::instance->now() : -1),
+      trace_start(Trace::isRecording() ? Trace::now() : -1),
+      tag((uint8_t)phase) {}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~Scope() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Profiler::Scope::~Scope() {
+  if (this->trace_start >= 0)
+    Trace::complete(NAMES[(size_t)this->phase], "frame", this->trace_start);
+
+  // Profiler might have been created or destroyed in between
+  if (this->start < 0 || !Profiler::instance) return;
+  Profiler::instance->current[(size_t)this->phase] +=
+      Profiler::instance->now() - this->start;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Profiler() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Profiler::Profiler(sf::Int32 budget)
+    : budget((sf::Int64)budget * 1000),
+      history(PHASES * WINDOW, 0),
+      allocation_history(PHASES * WINDOW) {
+  static_assert(PHASES <= AllocTracker::MAX_TAGS, "Too many phases");
+  Profiler::instance = this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* beginFrame() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Profiler::beginFrame() {
+  for (size_t i = 0; i < PHASES; i++) {
+    this->current[i] = 0;
+    this->allocations_start[i] = AllocTracker::get((uint8_t)i);
+  }
+  this->frame_start = now();
+  this->trace_frame_start = Trace::isRecording() ? Trace::now() : -1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* endFrame() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Profiler::endFrame() {
+  this->current[(size_t)Phase::Frame] = now() - this->frame_start;
+
+  // Before anything below allocates
+  AllocTracker::Counter total;
+  for (size_t i = 0; i < PHASES; i++) {
+    this->allocations[i] =
+        AllocTracker::get((uint8_t)i) - this->allocations_start[i];
+    total.allocations += this->allocations[i].allocations;
+    total.frees += this->allocations[i].frees;
+    total.bytes += this->allocations[i].bytes;
+  }
+  this->allocations[(size_t)Phase::Frame] = total;
+  if (this->trace_frame_start >= 0)
+    Trace::complete(NAMES[(size_t)Phase::Frame], "frame",
+                    this->trace_frame_start);
+
+  size_t index = (size_t)(this->frame % WINDOW);
+  for (size_t i = 0; i < PHASES; i++) {
+    this->history[i * WINDOW + index] = this->current[i];
+    this->allocation_history[i * WINDOW + index] = this->allocations[i];
+  }
+  if (this->frames < WINDOW) this->frames++;
+
+  // Capture if over budget
+  if (this->current[(size_t)Phase::Frame] - this->current[(size_t)Phase::Sleep] >
+      this->budget) {
+    Capture capture;
+    capture.frame = this->frame;
+    capture.time = this->frame_start / 1000;
+    for (size_t i = 0; i < PHASES; i++) {
+      capture.phases[i] = this->current[i];
+      capture.allocations[i] = this->allocations[i].allocations;
+    }
+    this->captures.push_back(capture);
+    while (this->captures.size() > MAX_CAPTURES) this->captures.pop_front();
+    this->slow_frames++;
+    if (this->capture_file.is_open()) writeCapture(capture);
+  }
+
+  if (now() / 1000 - this->last_summary >= SUMMARY_INTERVAL) updateSummary();
+  this->frame++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setCaptureFile() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Profiler::setCaptureFile(const std::string& file) {
+  this->capture_file.open(file, std::ios::out | std::ios::app);
+  if (!this->capture_file.is_open()) {
+    std::cerr << "Error while opening profiler file: " << file << std::endl;
+    return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getText() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> Profiler::getText() const {
+  auto ms = [](sf::Int64 us) {
+    char text[16];
+    snprintf(text, sizeof(text), "%7.2f", (double)us / 1000.0);
+    return std::string(text);
+  };
+
+  std::vector<std::string> lines;
+  char line[128];
+  snprintf(line, sizeof(line), "%-20s %7s %7s %7s %7s %7s %7s",
+           "Phase (ms)", "p50", "p95", "p99", "max", "allocs", "KiB");
+  lines.push_back(line);
+  for (size_t i = 0; i < PHASES; i++) {
+    const Summary& s = this->summary[i];
+    snprintf(line, sizeof(line), "%-20s", NAMES[i]);
+    std::string text = std::string(line) + " " + ms(s.p50) + " " +
+                       ms(s.p95) + " " + ms(s.p99) + " " + ms(s.max);
+    snprintf(line, sizeof(line), " %7.1f %7.1f", s.allocations,
+             s.bytes / 1024.f);
+    lines.push_back(text + line);
+  }
+
+  lines.push_back("Over budget (" + ms(this->budget) +
+                  " ms): " + std::to_string(this->slow_frames));
+  if (!this->captures.empty()) {
+    const Capture& last = this->captures.back();
+    lines.push_back("Last: frame " + std::to_string(last.frame) + " at " +
+                    std::to_string(last.time) + " ms");
+    for (size_t i = 0; i < PHASES; i++) {
+      if (last.phases[i] == 0) continue;
+      snprintf(line, sizeof(line), "  %-18s", NAMES[i]);
+      lines.push_back(std::string(line) + " " + ms(last.phases[i]) + " " +
+                      std::to_string(last.allocations[i]) + " allocs");
+    }
+  }
+  return lines;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* updateSummary() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Profiler::updateSummary() {
+  this->last_summary = now() / 1000;
+  if (this->frames == 0) return;
+
+  std::vector<sf::Int64> sorted(this->frames);
+  for (size_t i = 0; i < PHASES; i++) {
+    std::copy(this->history.begin() + i * WINDOW,
+              this->history.begin() + i * WINDOW + this->frames,
+              sorted.begin());
+    std::sort(sorted.begin(), sorted.end());
+    Summary& s = this->summary[i];
+    s.p50 = sorted[(this->frames - 1) * 50 / 100];
+    s.p95 = sorted[(this->frames - 1) * 95 / 100];
+    s.p99 = sorted[(this->frames - 1) * 99 / 100];
+    s.max = sorted.back();
+
+    sf::Uint64 allocations = 0, bytes = 0;
+    for (size_t k = 0; k < this->frames; k++) {
+      allocations += this->allocation_history[i * WINDOW + k].allocations;
+      bytes += this->allocation_history[i * WINDOW + k].bytes;
+    }
+    s.allocations = (float)allocations / this->frames;
+    s.bytes = (float)bytes / this->frames;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* writeCapture() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Profiler::writeCapture(const Capture& capture) {
+  this->capture_file << "{\"frame\":" << capture.frame
+                     << ",\"time\":" << capture.time << ",\"budget\":"
+                     << this->budget << ",\"phases\":{";
+  for (size_t i = 0; i < PHASES; i++) {
+    if (i > 0) this->capture_file << ",";
+    this->capture_file << "\"" << NAMES[i] << "\":" << capture.phases[i];
+  }
+  this->capture_file << "},\"allocations\":{";
+  for (size_t i = 0; i < PHASES; i++) {
+    if (i > 0) this->capture_file << ",";
+    this->capture_file << "\"" << NAMES[i] << "\":" << capture.allocations[i];
+  }
+  this->capture_file << "}}" << std::endl;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file profiler.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for Profiler class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "alloc_tracker.h"
+
+/** \class Profiler
+ *  @brief Measures the phases of every frame.
+ *
+ * Phases are measured with a Scope on the stack. The last WINDOW frames of
+ * every phase are kept to calculate p50, p95, p99 and max. A frame whose work
+ * (everything but the sleep of the main loop) exceeds the budget is captured
+ * with all its phases.
+ *
+ * Heap allocations are counted per phase as well (see AllocTracker). An
+ * allocation is counted in the innermost phase only, Frame shows the sum of
+ * all phases.
+ *
+ * There is at most one profiler per thread at a time (see getInstance()), so
+ * worlds updated by other threads don't add to it. Without one, a Scope does
+ * nothing. While a Trace is recording, every frame and Scope is
+ * added to it as well.
+ */
+class Profiler {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  /**
+   * @brief The measured phases. Phases may contain others (e.g. Update
+   * contains all Update... phases).
+   */
+  enum class Phase : uint8_t {
+    Frame,              /**< The whole loop */
+    Sleep,              /**< Waiting for the min loop time */
+    Events,             /**< Polling and handling events */
+    Update,             /**< World::update() */
+    UpdateScenes,       /**< Loading and removing scenes */
+    UpdateCollectables, /**< Updating and collecting collectables */
+    UpdateEnemies,      /**< Moving enemies */
+    UpdatePlayers,      /**< Moving players */
+    UpdateContacts,     /**< Contact of grounds */
+    Network,            /**< NetworkManager::update() */
+    Draw,               /**< World::draw() */
+    HUD,                /**< HUD and overlays */
+    Display,            /**< sf::RenderWindow::display() */
+    Count               /**< Number of phases */
+  };
+
+  static const size_t PHASES = (size_t)Phase::Count; /**< Number of phases */
+
+  static const size_t WINDOW = 300; /**< Frames kept per phase */
+
+  static const size_t MAX_CAPTURES = 32; /**< Captured frames kept */
+
+  static const sf::Int64 SUMMARY_INTERVAL =
+      500; /**< Interval in ms to recalculate the summary */
+
+  static const char* const NAMES[PHASES]; /**< Names of all phases */
+
+  /**
+   * @brief Percentiles of one phase over the last frames, in us, and its
+   * allocations per frame.
+   */
+  struct Summary {
+    sf::Int64 p50 = 0, p95 = 0, p99 = 0, max = 0;
+    float allocations = 0, /**< Mean allocations per frame */
+        bytes = 0;         /**< Mean allocated bytes per frame */
+  };
+
+  /**
+   * @brief A frame over budget.
+   */
+  struct Capture {
+    sf::Uint64 frame = 0;         /**< Number of the frame */
+    sf::Int64 time = 0;           /**< Start of the frame in ms */
+    sf::Int64 phases[PHASES] = {}; /**< Time of every phase in us */
+    sf::Uint64 allocations[PHASES] = {}; /**< Allocations of every phase */
+  };
+
+  /**
+   * @brief Measures a phase from construction to destruction.
+   *
+   * If a phase is measured more than once in a frame, the times are added.
+   */
+  class Scope {
+   private:
+    Phase phase;           /**< The measured phase */
+    sf::Int64 start;       /**< Start time in us, -1 without a profiler */
+    sf::Int64 trace_start; /**< Start in us of the trace, -1 if not
+                           recording */
+    AllocTracker::Tag tag; /**< Counts allocations in this phase */
+
+   public:
+    Scope(Phase phase);
+    ~Scope();
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  sf::Clock clock;         /**< Time of all measurements */
+  sf::Int64 budget;        /**< Max work time of a frame in us */
+  sf::Uint64 frame = 0;    /**< Number of the current frame */
+  sf::Int64 frame_start = 0; /**< Start time of the current frame in us */
+  sf::Int64 trace_frame_start =
+      -1; /**< Start of the current frame in us of the trace, -1 if not
+          recording */
+
+  sf::Int64 current[PHASES] = {}; /**< Phases of the current frame in us */
+  AllocTracker::Counter
+      allocations_start[PHASES]; /**< Counters at the start of the frame */
+  AllocTracker::Counter
+      allocations[PHASES]; /**< Allocations of the current frame */
+  std::vector<sf::Int64>
+      history; /**< Last WINDOW frames, WINDOW values per phase */
+  std::vector<AllocTracker::Counter>
+      allocation_history; /**< Allocations of the frames in history */
+  size_t frames = 0; /**< Number of valid frames in history (max WINDOW) */
+
+  Summary summary[PHASES];       /**< Last calculated summary */
+  sf::Int64 last_summary = 0;    /**< Time in ms of the last summary */
+  std::deque<Capture> captures;  /**< Frames over budget, oldest first */
+  sf::Uint64 slow_frames = 0;    /**< Number of frames over budget */
+  std::ofstream capture_file;    /**< Captures are appended to this, if open */
+
+  static thread_local Profiler*
+      instance; /**< Current instance of Profiler of this thread */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new Profiler object and makes it the instance.
+   *
+   * @param budget Max work time of a frame in ms.
+   */
+  Profiler(sf::Int32 budget);
+
+  /**
+   * @brief Destroys the Profiler object.
+   *
+   */
+  ~Profiler() {
+    if (Profiler::instance == this) Profiler::instance = nullptr;
+  }
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Starts a new frame.
+   *
+   */
+  void beginFrame();
+
+  /**
+   * @brief Ends the current frame, adds it to the history and captures it if
+   * it was over budget.
+   *
+   */
+  void endFrame();
+
+  /**
+   * @brief Opens a file every captured frame is appended to, one line of json
+   * each.
+   *
+   * @param file Path of the file.
+   * @return true On success.
+   * @return false If the file can't be opened.
+   */
+  bool setCaptureFile(const std::string& file);
+
+  /**
+   * @brief Returns the summary of all phases and the last captured frame as
+   * text, one line each.
+   *
+   * @return std::vector<std::string> The lines.
+   */
+  std::vector<std::string> getText() const;
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  static Profiler* getInstance() { return Profiler::instance; }
+
+  const Summary& getSummary(Phase phase) const {
+    return this->summary[(size_t)phase];
+  }
+
+  const std::deque<Capture>& getCaptures() const { return this->captures; }
+
+  sf::Uint64 getSlowFrames() const { return this->slow_frames; }
+
+ private:
+  /**
+   * @brief Calculates the summary of all phases from the history.
+   *
+   */
+  void updateSummary();
+
+  /**
+   * @brief Writes a captured frame as one line of json.
+   *
+   * @param capture The captured frame.
+   */
+  void writeCapture(const Capture& capture);
+
+  sf::Int64 now() const { return this->clock.getElapsedTime().asMicroseconds(); }
+};
@@ -0,0 +1,47 @@
+/**
+ * @file profiler_overlay.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for ProfilerOverlay class
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ *
+ */
+#include "profiler_overlay.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Static Variables */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+const std::string ProfilerOverlay::FONT_FILE = "Ressources/monofonto.ttf";
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ProfilerOverlay() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+ProfilerOverlay::ProfilerOverlay(sf::RenderWindow* window) : window(window) {
+  if (!this->font.loadFromFile(ProfilerOverlay::FONT_FILE)) exit(2);
+  this->text.setFont(this->font);
+  this->text.setCharacterSize((int)(this->window->getSize().y * .018f));
+  this->text.setFillColor(sf::Color(0, 0, 0, 255));
+  this->background.setFillColor(sf::Color(255, 255, 255, 200));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* draw() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void ProfilerOverlay::draw(const Profiler* profiler) {
+  std::string text;
+  for (const std::string& line : profiler->getText()) text += line + "\n";
+  this->text.setString(text);
+
+  sf::Vector2f position = this->window->mapPixelToCoords(sf::Vector2i(10, 10));
+  this->text.setPosition(position);
+  sf::FloatRect bounds = this->text.getGlobalBounds();
+  this->background.setPosition(position - sf::Vector2f(5, 5));
+  this->background.setSize(sf::Vector2f(bounds.width + 10 + bounds.left -
+                                            position.x,
+                                        bounds.height + 10 + bounds.top -
+                                            position.y));
+  this->window->draw(this->background);
+  this->window->draw(this->text);
+}
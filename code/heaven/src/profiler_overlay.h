@@ -0,0 +1,66 @@
+/**
+ * @file profiler_overlay.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for ProfilerOverlay class
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ *
+ */
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "profiler.h"
+
+/** \class ProfilerOverlay
+ *  @brief Class for displaying the summary of the Profiler ingame.
+ */
+class ProfilerOverlay {
+ public:
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+  static const sf::Keyboard::Key PROFILER_KEY =
+      sf::Keyboard::Key::F3; /**< The key which toggles the overlay */
+
+ private:
+  static const std::string FONT_FILE; /**< Path to the font file */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  sf::RenderWindow* window; /**< Pointer to the window to draw in */
+
+  sf::Text text; /**< The summary */
+  sf::Font font;
+  sf::RectangleShape background; /**< Keeps the text readable */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Creates a new Profiler Overlay object.
+   *
+   * @param window The window in which the overlay will be displayed
+   */
+  ProfilerOverlay(sf::RenderWindow* window);
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Draws the summary of the profiler in the upper left corner.
+   *
+   * @param profiler The profiler.
+   */
+  void draw(const Profiler* profiler);
+};
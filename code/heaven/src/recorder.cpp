@@ -0,0 +1,145 @@
+/**
+ * @file recorder.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for Recorder class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "recorder.h"
+
+#include <iomanip>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Static Variables */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+const std::string Recorder::HEADER = "heaven-recording 1";
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Recorder() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Recorder::Recorder(const std::string& file, const World* world,
+                   const std::string& scenes)
+    : file(file, std::ios::out | std::ios::trunc), state(world->getState()) {
+  if (!this->file.is_open()) {
+    std::cerr << "Error while opening recording: " << file << std::endl;
+    return;
+  }
+  this->file << HEADER << "\n"
+             << "seed " << world->getSeed() << "\n"
+             << "size " << world->getSize().x << " " << world->getSize().y
+             << "\n"
+             << "scenes " << (scenes.empty() ? "-" : scenes) << "\n";
+  this->file << std::hexfloat;
+  this->file << "activation " << world->getActivationDistance() << "\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* beginTick() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Recorder::beginTick(float factor) {
+  if (!isOpen()) return;
+  this->tick++;
+  this->file << "t " << factor << "\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* recordKey() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Recorder::recordKey(const sf::Event& event) {
+  if (!isOpen() || event.key.code == sf::Keyboard::Escape ||
+      event.key.code == sf::Keyboard::F6)
+    return;
+  this->file << "k " << std::dec << (int)event.key.code << " "
+             << (event.type == sf::Event::KeyPressed ? 1 : 0) << "\n"
+             << std::hexfloat;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* recordPacket() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Recorder::recordPacket(const sf::Packet& packet) {
+  if (!isOpen()) return;
+  static const char HEX[] = "0123456789abcdef";
+  const sf::Uint8* data = (const sf::Uint8*)packet.getData();
+  std::string line(packet.getDataSize() * 2, '0');
+  for (size_t i = 0; i < packet.getDataSize(); i++) {
+    line[i * 2] = HEX[data[i] >> 4];
+    line[i * 2 + 1] = HEX[data[i] & 0xF];
+  }
+  this->file << "p " << line << "\n";
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* endTick() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Recorder::endTick(World* world) {
+  if (!isOpen()) return;
+
+  if (world->getState() != this->state) {
+    this->state = world->getState();
+    this->file << "m " << std::dec << (int)this->state << "\n"
+               << std::hexfloat;
+  }
+
+  if (this->tick % KEYFRAME_INTERVAL != 0) return;
+  Keyframe keyframe = capture(world, this->tick);
+  this->file << "f " << std::dec << keyframe.checksum << " " << std::hexfloat
+             << keyframe.position.x << " " << keyframe.position.y << " "
+             << keyframe.vertical_speed << " " << std::dec << keyframe.hp
+             << " " << keyframe.coins << "\n"
+             << std::hexfloat;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* capture() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Recorder::Keyframe Recorder::capture(World* world, sf::Uint64 tick) {
+  // FNV-1a over the raw values
+  sf::Uint32 hash = 2166136261u;
+  auto add = [&hash](const void* data, size_t size) {
+    const sf::Uint8* bytes = (const sf::Uint8*)data;
+    for (size_t i = 0; i < size; i++) {
+      hash ^= bytes[i];
+      hash *= 16777619u;
+    }
+  };
+  auto addPosition = [&add](const sf::Vector2f& position) {
+    add(&position.x, sizeof(position.x));
+    add(&position.y, sizeof(position.y));
+  };
+
+  for (auto player : world->getPlayers()) {
+    addPosition(player->getPosition());
+    float vertical_speed = player->getVerticalSpeed();
+    int hp = player->getHP();
+    add(&vertical_speed, sizeof(vertical_speed));
+    add(&hp, sizeof(hp));
+  }
+  for (auto enemy : world->getEnemies()) {
+    addPosition(enemy->getPosition());
+    int hp = enemy->getHP();
+    add(&hp, sizeof(hp));
+  }
+  for (auto ground : world->getGrounds())
+    addPosition(sf::Vector2f(ground->getGlobalBounds().left,
+                             ground->getGlobalBounds().top));
+  for (auto collectable : world->getCollectables())
+    addPosition(collectable->getPosition());
+
+  Keyframe keyframe;
+  keyframe.tick = tick;
+  keyframe.checksum = hash;
+  if (!world->getPlayers().empty()) {
+    Characters::Player* player = world->getPlayer(0);
+    keyframe.position = player->getPosition();
+    keyframe.vertical_speed = player->getVerticalSpeed();
+    keyframe.hp = player->getHP();
+    keyframe.coins = player->getCoins();
+  }
+  return keyframe;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file recorder.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for Recorder class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Network.hpp>
+#include <SFML/Window.hpp>
+#include <fstream>
+#include <string>
+
+#include "world.h"
+
+/** \class Recorder
+ *  @brief Records everything needed to replay a game exactly.
+ *
+ * The recording is a text file. After the header (seed, size, scene order
+ * and activation distance of the world) there is one line per event:
+ *  - "t <factor>": Starts a new tick (one loop of the main loop) with the time
+ *    factor given to the world.
+ *  - "k <key code> <1 if pressed, 0 if released>": Key event of this tick,
+ *    applied before updating the world.
+ *  - "p <data as hex>": Packet received in this tick.
+ *  - "m <state>": The world changed its state (e.g. started as host).
+ *  - "f <checksum> <x> <y> <vertical speed> <hp> <coins>": Keyframe after
+ *    this tick, every KEYFRAME_INTERVAL ticks.
+ * Floats are written as hex floats, so they are read back exactly.
+ */
+class Recorder {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const std::string HEADER; /**< First line of every recording */
+
+  static const sf::Uint64 KEYFRAME_INTERVAL =
+      100; /**< Ticks between two keyframes */
+
+  /**
+   * @brief State of the world after a tick.
+   *
+   * Only enough to detect a divergence, the world can't be restored from it.
+   */
+  struct Keyframe {
+    sf::Uint64 tick = 0;       /**< Number of ticks done */
+    sf::Uint32 checksum = 0;   /**< Hash of all players, enemies, grounds and
+                               collectables */
+    sf::Vector2f position;     /**< Position of the main player */
+    float vertical_speed = 0;  /**< Vertical speed of the main player */
+    int hp = 0;                /**< HP of the main player */
+    uint16_t coins = 0;        /**< Coins of the main player */
+
+    bool operator==(const Keyframe& other) const {
+      return checksum == other.checksum && position == other.position &&
+             vertical_speed == other.vertical_speed && hp == other.hp &&
+             coins == other.coins;
+    }
+
+    bool operator!=(const Keyframe& other) const { return !(*this == other); }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  std::ofstream file;      /**< The recording */
+  sf::Uint64 tick = 0;     /**< Number of started ticks */
+  World::State state;      /**< Last recorded state of the world */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new Recorder object and writes the header.
+   *
+   * Must be created before the first scene after the spawn is loaded.
+   *
+   * @param file Path of the recording.
+   * @param world The recorded world.
+   * @param scenes The scene order given to the world or an empty string.
+   */
+  Recorder(const std::string& file, const World* world,
+           const std::string& scenes);
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Starts a new tick.
+   *
+   * @param factor The time factor given to World::update().
+   */
+  void beginTick(float factor);
+
+  /**
+   * @brief Records a key event given to the KeyHandler.
+   *
+   * Escape and F6 are not recorded, they close the window.
+   *
+   * @param event The KeyPressed or KeyReleased event.
+   */
+  void recordKey(const sf::Event& event);
+
+  /**
+   * @brief Records a received packet.
+   *
+   * @param packet The packet, unread.
+   */
+  void recordPacket(const sf::Packet& packet);
+
+  /**
+   * @brief Ends the current tick and writes a keyframe if needed.
+   *
+   * @param world The recorded world.
+   */
+  void endTick(World* world);
+
+  /**
+   * @brief Captures the state of a world.
+   *
+   * @param world The world.
+   * @param tick The number of ticks done.
+   * @return Keyframe The state.
+   */
+  static Keyframe capture(World* world, sf::Uint64 tick);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  bool isOpen() const { return this->file.is_open(); }
+};
@@ -0,0 +1,171 @@
+/**
+ * @file replayer.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for Replayer class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "replayer.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "frame_arena.h"
+#include "key_handler.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* load() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Replayer::load(const std::string& file) {
+  std::ifstream in(file);
+  if (!in.is_open()) {
+    std::cerr << "Error while opening recording: " << file << std::endl;
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(in, line) || line != Recorder::HEADER) {
+    std::cerr << "Not a recording: " << file << std::endl;
+    return false;
+  }
+
+  this->ticks.clear();
+  this->packets = 0;
+  size_t line_number = 1;
+  while (std::getline(in, line)) {
+    line_number++;
+    if (line.empty()) continue;
+    std::istringstream stream(line);
+    std::string type;
+    stream >> type;
+
+    if (type == "t") {
+      Tick tick;
+      // operator>> can't read hex floats
+      std::string factor;
+      stream >> factor;
+      tick.factor = std::strtof(factor.c_str(), nullptr);
+      this->ticks.push_back(tick);
+      continue;
+    }
+
+    if (type == "seed") {
+      stream >> this->seed;
+    } else if (type == "size") {
+      stream >> this->size.x >> this->size.y;
+    } else if (type == "scenes") {
+      stream >> this->scenes;
+      if (this->scenes == "-") this->scenes.clear();
+    } else if (type == "activation") {
+      std::string distance;
+      stream >> distance;
+      this->activation_distance = std::strtof(distance.c_str(), nullptr);
+    } else if (this->ticks.empty()) {
+      std::cerr << "Event before first tick in line " << line_number
+                << std::endl;
+      return false;
+    } else if (type == "k") {
+      int code, pressed;
+      stream >> code >> pressed;
+      this->ticks.back().keys.push_back(std::pair<sf::Keyboard::Key, bool>(
+          (sf::Keyboard::Key)code, pressed != 0));
+    } else if (type == "p") {
+      this->packets++;
+    } else if (type == "m") {
+      this->ticks.back().state_changed = true;
+    } else if (type == "f") {
+      Tick& tick = this->ticks.back();
+      std::string x, y, vertical_speed;
+      stream >> tick.expected.checksum >> x >> y >> vertical_speed >>
+          tick.expected.hp >> tick.expected.coins;
+      tick.expected.tick = this->ticks.size();
+      tick.expected.position.x = std::strtof(x.c_str(), nullptr);
+      tick.expected.position.y = std::strtof(y.c_str(), nullptr);
+      tick.expected.vertical_speed =
+          std::strtof(vertical_speed.c_str(), nullptr);
+      tick.keyframe = true;
+    } else {
+      std::cerr << "Unknown record '" << type << "' in line " << line_number
+                << std::endl;
+      return false;
+    }
+
+    if (stream.fail()) {
+      std::cerr << "Invalid record in line " << line_number << std::endl;
+      return false;
+    }
+  }
+
+  if (this->size.x == 0 || this->size.y == 0) {
+    std::cerr << "Recording has no size: " << file << std::endl;
+    return false;
+  }
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* run() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Replayer::run(sf::Uint64 until, Recorder::Keyframe* last) {
+  // Same setup as main, without a window
+  World* world = nullptr;
+  std::vector<char> scenes(this->scenes.begin(), this->scenes.end());
+  scenes.push_back('\0');
+  if (!this->scenes.empty())
+    world = new World(this->size, scenes.data(), World::State::Local);
+  else
+    world = new World(this->size, World::State::Local);
+  world->setSeed(this->seed);
+  world->setActivationDistance(this->activation_distance);
+  Characters::Player* player =
+      new Characters::Player(Characters::Player::START_POSITION, true);
+  world->addPlayer(player);
+  world->init();
+
+  KeyHandler key_handler(nullptr, player, world);
+
+  if (until == 0 || until > this->ticks.size()) until = this->ticks.size();
+
+  bool diverged = false;
+  sf::Uint64 done = 0;
+  for (; done < until; done++) {
+    const Tick& tick = this->ticks[done];
+    if (tick.state_changed) {
+      std::cout << "World left local state in tick " << done + 1
+                << ", stopping replay." << std::endl;
+      break;
+    }
+
+    for (auto key : tick.keys) {
+      sf::Event event;
+      event.type = key.second ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+      std::memset(&event.key, 0, sizeof(event.key));
+      event.key.code = key.first;
+      if (key.second)
+        key_handler.keyPressed(event, tick.factor);
+      else
+        key_handler.keyReleased(event, tick.factor);
+    }
+    world->update(tick.factor);
+    FrameArena::get().reset();
+
+    if (tick.keyframe && !diverged) {
+      Recorder::Keyframe actual = Recorder::capture(world, done + 1);
+      if (actual != tick.expected) {
+        std::cerr << "Replay diverged in tick " << done + 1 << ": expected "
+                  << tick.expected.position.x << "/"
+                  << tick.expected.position.y << " got " << actual.position.x
+                  << "/" << actual.position.y << std::endl;
+        diverged = true;
+      }
+    }
+  }
+
+  if (last != nullptr) *last = Recorder::capture(world, done);
+  delete world;
+  return !diverged;
+}
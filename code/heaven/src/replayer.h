@@ -0,0 +1,92 @@
+/**
+ * @file replayer.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for Replayer class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/Window.hpp>
+#include <string>
+#include <vector>
+
+#include "recorder.h"
+#include "world.h"
+
+/** \class Replayer
+ *  @brief Replays a recording of the Recorder without a window.
+ *
+ * The world is simulated as fast as possible with the recorded seed, scene
+ * order, time factors and key events. The keyframes of the recording are
+ * compared with the replayed world to detect a divergence.
+ *
+ * Not supported:
+ *  - Seeking: A keyframe only identifies a state, it can't be restored. So
+ *    replaying until a tick always simulates all ticks before it, which is
+ *    fast without drawing.
+ *  - Networked games: Only the local part is replayed. Received packets are
+ *    stored in the recording but only counted, and the replay stops when the
+ *    world became a host or client.
+ */
+class Replayer {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  /**
+   * @brief Everything recorded in one tick.
+   */
+  struct Tick {
+    float factor = 0; /**< Time factor given to the world */
+    std::vector<std::pair<sf::Keyboard::Key, bool>>
+        keys;            /**< Key codes with true if pressed */
+    bool keyframe = false; /**< Whether a keyframe follows this tick */
+    Recorder::Keyframe expected; /**< The recorded keyframe */
+    bool state_changed = false;  /**< Whether the world left local state */
+  };
+
+  sf::Uint32 seed = 0;           /**< Seed of the world */
+  sf::Vector2u size;             /**< Size of the world */
+  std::string scenes;            /**< Scene order or empty */
+  float activation_distance =
+      World::ACTIVATION_DISTANCE; /**< Activation distance of the world */
+  std::vector<Tick> ticks;       /**< All recorded ticks */
+  size_t packets = 0;            /**< Number of recorded packets */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Loads a recording.
+   *
+   * @param file Path of the recording.
+   * @return bool False if the file couldn't be read.
+   */
+  bool load(const std::string& file);
+
+  /**
+   * @brief Replays the loaded recording.
+   *
+   * @param until Number of ticks to replay, 0 for all.
+   * @param last Set to the state of the world after the last replayed tick.
+   * @return bool False if the replay diverged from a recorded keyframe.
+   */
+  bool run(sf::Uint64 until, Recorder::Keyframe* last);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  size_t getTickCount() const { return this->ticks.size(); }
+  size_t getPacketCount() const { return this->packets; }
+};
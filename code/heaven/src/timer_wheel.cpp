@@ -0,0 +1,156 @@
+/**
+ * @file timer_wheel.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for TimerWheel and Timer class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "timer_wheel.h"
+
+#include "job_system.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Timer::start() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Timer::start(TimerWheel* wheel, sf::Uint32 ms) {
+  // The wheel is shared by all items of a parallel loop
+  if (JobSystem::isInJob()) {
+    JobSystem::defer([this, wheel, ms]() { start(wheel, ms); });
+    return;
+  }
+
+  stop();
+  if (!wheel) return;
+
+  if (ms == 0) ms = 1;  // The current ms is already done
+  this->wheel = wheel;
+  this->expires = wheel->now + ms;
+  wheel->add(this);
+  wheel->running++;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Timer::stop() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Timer::stop() {
+  if (!this->wheel) return;
+  this->wheel->remove(this);
+  this->wheel->running--;
+  this->wheel = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Timer::getRemaining() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Uint32 Timer::getRemaining() const {
+  if (!this->wheel) return 0;
+  return (sf::Uint32)(this->expires - this->wheel->now);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~TimerWheel() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+TimerWheel::~TimerWheel() {
+  // Owners may outlive the wheel, so their timers must not point to it
+  auto detach = [](Timer* timer) {
+    while (timer) {
+      Timer* next = timer->next;
+      timer->wheel = nullptr;
+      timer->slot = nullptr;
+      timer->prev = timer->next = nullptr;
+      timer = next;
+    }
+  };
+  for (auto timer : this->root) detach(timer);
+  for (auto& level : this->levels)
+    for (auto timer : level) detach(timer);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* advance() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::advance(sf::Uint32 ms) {
+  for (sf::Uint32 i = 0; i < ms; i++) {
+    this->now++;
+
+    // Start of a turn of level 0 -> refill it from the levels above
+    size_t index = this->now & ((1 << ROOT_BITS) - 1);
+    if (index == 0)
+      for (unsigned int level = 1; level < LEVELS; level++)
+        if (cascade(level) != 0) break;
+
+    if (!this->running) continue;
+
+    // Callbacks can start or delete any timer, so always take the head
+    Timer** slot = &this->root[index];
+    while (*slot) {
+      Timer* timer = *slot;
+      remove(timer);
+      this->running--;
+      timer->wheel = nullptr;
+      if (timer->callback) timer->callback();
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* add() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::add(Timer* timer) {
+  if (timer->expires - this->now > MAX_TIMEOUT)
+    timer->expires = this->now + MAX_TIMEOUT;
+  sf::Uint64 delta = timer->expires - this->now;
+
+  Timer** slot;
+  if (delta < ((sf::Uint64)1 << ROOT_BITS)) {
+    slot = &this->root[timer->expires & ((1 << ROOT_BITS) - 1)];
+  } else {
+    unsigned int level = 1;
+    while (delta >= ((sf::Uint64)1 << (ROOT_BITS + level * LEVEL_BITS)))
+      level++;
+    size_t index = (timer->expires >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) &
+                   ((1 << LEVEL_BITS) - 1);
+    slot = &this->levels[level - 1][index];
+  }
+
+  timer->slot = slot;
+  timer->prev = nullptr;
+  timer->next = *slot;
+  if (*slot) (*slot)->prev = timer;
+  *slot = timer;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* remove() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void TimerWheel::remove(Timer* timer) {
+  if (timer->prev)
+    timer->prev->next = timer->next;
+  else
+    *timer->slot = timer->next;
+  if (timer->next) timer->next->prev = timer->prev;
+  timer->slot = nullptr;
+  timer->prev = timer->next = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* cascade() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+size_t TimerWheel::cascade(unsigned int level) {
+  size_t index = (this->now >> (ROOT_BITS + (level - 1) * LEVEL_BITS)) &
+                 ((1 << LEVEL_BITS) - 1);
+
+  // All timers of this slot expire within the turn of the level below
+  Timer* timer = this->levels[level - 1][index];
+  this->levels[level - 1][index] = nullptr;
+  while (timer) {
+    Timer* next = timer->next;
+    add(timer);
+    timer = next;
+  }
+  return index;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file timer_wheel.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for TimerWheel and Timer class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+#include <functional>
+
+class TimerWheel;
+
+/** \class Timer
+ *  @brief A timeout in simulation time, run by a TimerWheel.
+ *
+ * Used as a member of the object it belongs to. Without callback it is a
+ * cooldown (check isRunning()), with callback the callback is called by
+ * TimerWheel::advance() when it expires. A callback may start or destroy
+ * its own timer.
+ *
+ * Can't be copied, since the wheel links to it.
+ */
+class Timer {
+  friend class TimerWheel;
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  TimerWheel* wheel = nullptr; /**< The wheel while running */
+  Timer** slot = nullptr;      /**< Head of the list this timer is in */
+  Timer *prev = nullptr,       /**< Previous timer in the slot */
+      *next = nullptr;         /**< Next timer in the slot */
+  sf::Uint64 expires = 0;      /**< Wheel time of the expiry in ms */
+
+  std::function<void()> callback; /**< Called on expiry, may be empty */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  Timer() {}
+
+  /**
+   * @brief Constructs a new Timer object.
+   *
+   * @param callback Called on expiry.
+   */
+  Timer(const std::function<void()>& callback) : callback(callback) {}
+
+  /**
+   * @brief Destroys the Timer object and removes it from its wheel.
+   *
+   */
+  ~Timer() { stop(); }
+
+  Timer(const Timer&) = delete;
+  Timer& operator=(const Timer&) = delete;
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief (Re-)starts this timer.
+   *
+   * Does nothing without a wheel (the owner isn't part of a World), so the
+   * timer is never running then. Inside of JobSystem::parallelFor() it is
+   * started after the loop (see JobSystem::defer()).
+   *
+   * @param wheel The wheel.
+   * @param ms Time until the expiry in ms of simulation time, at least 1.
+   */
+  void start(TimerWheel* wheel, sf::Uint32 ms);
+
+  /**
+   * @brief Stops this timer without calling the callback.
+   *
+   */
+  void stop();
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  bool isRunning() const { return this->wheel != nullptr; }
+
+  /**
+   * @brief Returns the time until the expiry.
+   *
+   * @return sf::Uint32 The time in ms or 0 if not running.
+   */
+  sf::Uint32 getRemaining() const;
+
+  void setCallback(const std::function<void()>& callback) {
+    this->callback = callback;
+  }
+};
+
+/** \class TimerWheel
+ *  @brief Runs all Timers of a World in simulation time.
+ *
+ * Hierarchical timer wheel (like the one of the Linux kernel) with a
+ * resolution of 1 ms. The first level has a slot for each of the next 256
+ * ms, every further level has 64 slots that each cover a whole turn of the
+ * level below and are moved down (cascaded) when the level below starts
+ * its next turn. Starting, stopping and expiring a timer is O(1), each
+ * timer is cascaded at most LEVELS - 1 times. Timeouts longer than
+ * MAX_TIMEOUT are shortened to it.
+ *
+ * The time only moves forward with advance(), called by World::update(), so
+ * timers pause, replay and fast-forward together with the world.
+ */
+class TimerWheel {
+  friend class Timer;
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const unsigned int ROOT_BITS = 8, /**< log2 of slots of level 0 */
+      LEVEL_BITS = 6,                      /**< log2 of slots of levels > 0 */
+      LEVELS = 4;                          /**< Number of levels */
+
+  static const sf::Uint64 MAX_TIMEOUT =
+      ((sf::Uint64)1 << (ROOT_BITS + (LEVELS - 1) * LEVEL_BITS)) -
+      1; /**< Max timeout in ms (about 18 hours) */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  Timer* root[1 << ROOT_BITS] = {}; /**< Level 0, one slot per ms */
+  Timer* levels[LEVELS - 1][1 << LEVEL_BITS] = {}; /**< Levels 1.. */
+
+  sf::Uint64 now = 0;     /**< Current time in ms */
+  size_t running = 0;     /**< Number of running timers */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  TimerWheel() {}
+
+  /**
+   * @brief Destroys the Timer Wheel object, running timers are stopped.
+   *
+   */
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Moves the time forward and calls the callbacks of all timers that
+   * expired on the way, in order of their expiry.
+   *
+   * @param ms The time in ms.
+   */
+  void advance(sf::Uint32 ms);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Returns the time since the wheel was created.
+   *
+   * @return sf::Uint64 The time in ms.
+   */
+  sf::Uint64 getTime() const { return this->now; }
+
+  size_t getRunning() const { return this->running; }
+
+  // ----------------------------------------- //
+  /* Private Methods */
+  // ----------------------------------------- //
+ private:
+  /**
+   * @brief Puts a timer into the slot for its expiry.
+   *
+   * @param timer The timer, not in a slot.
+   */
+  void add(Timer* timer);
+
+  /**
+   * @brief Removes a timer from its slot.
+   *
+   * @param timer The timer.
+   */
+  void remove(Timer* timer);
+
+  /**
+   * @brief Moves all timers of a slot of a level > 0 to lower levels.
+   *
+   * @param level The level, 1 to LEVELS - 1.
+   * @return size_t The index of the slot.
+   */
+  size_t cascade(unsigned int level);
+};
@@ -0,0 +1,211 @@
+/**
+ * @file trace.cpp
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Source file for Trace class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#include "trace.h"
+
+#include <fstream>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Static Variables */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+Trace* Trace::instance = nullptr;
+
+std::atomic<uint32_t> Trace::next_thread(0);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* Trace() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Trace::Trace(const std::string& file)
+    : head(0),
+      recording(false),
+      file(file),
+      epoch(std::chrono::steady_clock::now()) {
+  Trace::instance = this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* ~Trace() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Trace::~Trace() {
+  if (this->recording.load()) stop();
+  if (Trace::instance == this) Trace::instance = nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* start() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::start() {
+  if (this->recording.load()) return;
+  if (!this->ring) this->ring.reset(new Event[CAPACITY]);
+  this->first = this->head.load(std::memory_order_acquire);
+  this->recording.store(true, std::memory_order_release);
+  std::cout << "Trace recording started." << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* stop() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+bool Trace::stop() {
+  if (!this->recording.load()) return true;
+  this->recording.store(false, std::memory_order_release);
+
+  this->recordings++;
+  std::string path = this->file;
+  if (this->recordings > 1) path += "." + std::to_string(this->recordings);
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    std::cerr << "Error while opening trace file: " << path << std::endl;
+    return false;
+  }
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool separator = false;
+  {
+    std::lock_guard<std::mutex> lock(this->thread_names_mutex);
+    for (auto& thread : this->thread_names) {
+      if (separator) out << ",";
+      out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+          << thread.first << ",\"args\":{\"name\":\"" << thread.second
+          << "\"}}";
+      separator = true;
+    }
+  }
+
+  // Only the newest CAPACITY events are still in the ring
+  uint64_t end = this->head.load(std::memory_order_acquire);
+  uint64_t begin = this->first;
+  if (end - begin > CAPACITY) begin = end - CAPACITY;
+  size_t dropped = 0;
+  for (uint64_t i = begin; i < end; i++) {
+    const Event& slot = this->ring[i & (CAPACITY - 1)];
+    // Copy and check the slot was not written meanwhile
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != i + 1) {
+      dropped++;
+      continue;
+    }
+    const char* name = slot.name;
+    const char* category = slot.category;
+    sf::Int64 start = slot.start, duration = slot.duration;
+    const char* arg_names[2] = {slot.arg_names[0], slot.arg_names[1]};
+    sf::Int64 args[2] = {slot.args[0], slot.args[1]};
+    uint32_t thread = slot.thread;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      dropped++;
+      continue;
+    }
+
+    if (separator) out << ",";
+    separator = true;
+    out << "{\"name\":\"" << name << "\",\"cat\":\"" << category
+        << "\",\"pid\":1,\"tid\":" << thread << ",\"ts\":" << start;
+    if (duration >= 0)
+      out << ",\"ph\":\"X\",\"dur\":" << duration;
+    else
+      out << ",\"ph\":\"i\",\"s\":\"t\"";
+    if (arg_names[0]) {
+      out << ",\"args\":{\"" << arg_names[0] << "\":" << args[0];
+      if (arg_names[1]) out << ",\"" << arg_names[1] << "\":" << args[1];
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "]}" << std::endl;
+
+  std::cout << "Trace written to " << path << " (" << end - begin - dropped
+            << " events";
+  if (end - this->first > CAPACITY)
+    std::cout << ", " << end - this->first - CAPACITY << " oldest overwritten";
+  std::cout << ")." << std::endl;
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* toggle() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::toggle() {
+  if (this->recording.load())
+    stop();
+  else
+    start();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* complete() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::complete(const char* name, const char* category, sf::Int64 start) {
+  if (!isRecording()) return;
+  Trace::instance->push(name, category, start, now() - start, nullptr, 0,
+                        nullptr, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* instant() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::instant(const char* name, const char* category,
+                    const char* arg_name, sf::Int64 arg, const char* arg2_name,
+                    sf::Int64 arg2) {
+  if (!isRecording()) return;
+  Trace::instance->push(name, category, now(), -1, arg_name, arg, arg2_name,
+                        arg2);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setThreadName() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::setThreadName(const std::string& name) {
+  if (!Trace::instance) return;
+  std::lock_guard<std::mutex> lock(Trace::instance->thread_names_mutex);
+  Trace::instance->thread_names[getThreadId()] = name;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* now() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+sf::Int64 Trace::now() {
+  if (!Trace::instance) return 0;
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - Trace::instance->epoch)
+      .count();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getThreadId() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+uint32_t Trace::getThreadId() {
+  static thread_local uint32_t id = Trace::next_thread.fetch_add(1);
+  return id;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* push() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void Trace::push(const char* name, const char* category, sf::Int64 start,
+                 sf::Int64 duration, const char* arg_name, sf::Int64 arg,
+                 const char* arg2_name, sf::Int64 arg2) {
+  uint64_t index = this->head.fetch_add(1, std::memory_order_relaxed);
+  Event& slot = this->ring[index & (CAPACITY - 1)];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name = name;
+  slot.category = category;
+  slot.start = start;
+  slot.duration = duration;
+  slot.arg_names[0] = arg_name;
+  slot.arg_names[1] = arg2_name;
+  slot.args[0] = arg;
+  slot.args[1] = arg2;
+  slot.thread = getThreadId();
+  slot.sequence.store(index + 1, std::memory_order_release);
+}
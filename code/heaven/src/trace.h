@@ -0,0 +1,218 @@
+/**
+ * @file trace.h
+ * @author Philip Hönnecke (p.hoennecke@tu-braunschweig.de)
+ * @brief Header file for Trace class.
+ * @version 0.1
+ * @date 2020-02-11
+ *
+ * @copyright Copyright (c) 2019
+ *
+ */
+
+#pragma once
+
+#include <SFML/System.hpp>
+#include <SFML/Window.hpp>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/** \class Trace
+ *  @brief Records a timeline as Chrome trace events (chrome://tracing or
+ * Perfetto).
+ *
+ * While recording, events are written into a ring of CAPACITY events. Any
+ * thread may add events without locking: each event reserves its slot with
+ * one atomic increment. If the ring is full, the oldest events are
+ * overwritten. Nothing is written to disk before the recording stops, so
+ * recording doesn't change the timing of a frame.
+ *
+ * Names, categories and argument names of events must be string literals.
+ *
+ * There is at most one trace at a time (see getInstance()). Without one, or
+ * while not recording, adding an event does nothing.
+ */
+class Trace {
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Constant Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  static const sf::Keyboard::Key TRACE_KEY =
+      sf::Keyboard::Key::F9; /**< The key which toggles recording */
+
+  static const size_t CAPACITY = 1 << 17; /**< Events kept, power of 2 */
+
+  /**
+   * @brief Adds a complete event from construction to destruction.
+   */
+  class Scope {
+   private:
+    const char* name;     /**< Name of the event */
+    const char* category; /**< Category of the event */
+    sf::Int64 start;      /**< Start in us, -1 if not recording */
+
+   public:
+    Scope(const char* name, const char* category)
+        : name(name),
+          category(category),
+          start(Trace::isRecording() ? Trace::now() : -1) {}
+    ~Scope() {
+      if (this->start >= 0) Trace::complete(this->name, this->category, start);
+    }
+  };
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Other Variables */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ private:
+  /**
+   * @brief One slot of the ring.
+   */
+  struct Event {
+    std::atomic<uint64_t> sequence; /**< Index of the event + 1 when written
+                                    completely, 0 while being written */
+    const char* name = nullptr;     /**< Name of the event */
+    const char* category = nullptr; /**< Category of the event */
+    sf::Int64 start = 0;            /**< Start in us */
+    sf::Int64 duration = -1;        /**< Duration in us, -1 for instants */
+    const char* arg_names[2] = {};  /**< Names of the args, nullptr if unused */
+    sf::Int64 args[2] = {};         /**< Values of the args */
+    uint32_t thread = 0;            /**< Id of the thread (getThreadId()) */
+
+    Event() : sequence(0) {}
+  };
+
+  std::unique_ptr<Event[]> ring; /**< All events, allocated on first start */
+  std::atomic<uint64_t> head;    /**< Index of the next event */
+  uint64_t first = 0;            /**< Index of the first recorded event */
+  std::atomic<bool> recording;   /**< Whether events are recorded */
+
+  std::string file;      /**< Path of the first recording */
+  unsigned recordings = 0; /**< Number of written recordings */
+  std::chrono::steady_clock::time_point epoch; /**< Time 0 of all events */
+
+  std::mutex thread_names_mutex; /**< Guards thread_names */
+  std::map<uint32_t, std::string>
+      thread_names; /**< Key: thread id; val: name shown in the timeline */
+
+  static Trace* instance; /**< Current instance of Trace */
+
+  static std::atomic<uint32_t> next_thread; /**< Id of the next new thread */
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+  /* Methods */
+  ///////////////////////////////////////////////////////////////////////////////////////////////////
+ public:
+  // ----------------------------------------- //
+  /* Constructors */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Constructs a new Trace object and makes it the instance.
+   *
+   * @param file Path of the first recording. Later recordings get a number
+   * appended (file.2, file.3, ...).
+   */
+  Trace(const std::string& file);
+
+  /**
+   * @brief Writes the current recording, if any, and destroys the Trace
+   * object.
+   *
+   */
+  ~Trace();
+
+  // ----------------------------------------- //
+  /* Other Methods */
+  // ----------------------------------------- //
+
+  /**
+   * @brief Starts a new recording.
+   *
+   */
+  void start();
+
+  /**
+   * @brief Stops the recording and writes it as json.
+   *
+   * @return true On success.
+   * @return false If the file can't be written.
+   */
+  bool stop();
+
+  /**
+   * @brief Starts or stops the recording.
+   *
+   */
+  void toggle();
+
+  /**
+   * @brief Adds a complete event that ends now.
+   *
+   * @param name Name of the event.
+   * @param category Category of the event.
+   * @param start Start of the event (now() at that time).
+   */
+  static void complete(const char* name, const char* category,
+                       sf::Int64 start);
+
+  /**
+   * @brief Adds an instant event with up to two args.
+   *
+   * @param name Name of the event.
+   * @param category Category of the event.
+   * @param arg_name Name of the first arg or nullptr.
+   * @param arg Value of the first arg.
+   * @param arg2_name Name of the second arg or nullptr.
+   * @param arg2 Value of the second arg.
+   */
+  static void instant(const char* name, const char* category,
+                      const char* arg_name = nullptr, sf::Int64 arg = 0,
+                      const char* arg2_name = nullptr, sf::Int64 arg2 = 0);
+
+  /**
+   * @brief Sets the name of the calling thread in the timeline.
+   *
+   * @param name The name.
+   */
+  static void setThreadName(const std::string& name);
+
+  // ----------------------------------------- //
+  /* Getter / Setter */
+  // ----------------------------------------- //
+
+  static Trace* getInstance() { return Trace::instance; }
+
+  static bool isRecording() {
+    return Trace::instance &&
+           Trace::instance->recording.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the current time of the trace.
+   *
+   * @return sf::Int64 Time in us since the trace was created, 0 without a
+   * trace.
+   */
+  static sf::Int64 now();
+
+  /**
+   * @brief Returns the id of the calling thread, given in order of the first
+   * call.
+   *
+   * @return uint32_t The id.
+   */
+  static uint32_t getThreadId();
+
+ private:
+  /**
+   * @brief Reserves the next slot of the ring and writes an event into it.
+   *
+   */
+  void push(const char* name, const char* category, sf::Int64 start,
+            sf::Int64 duration, const char* arg_name, sf::Int64 arg,
+            const char* arg2_name, sf::Int64 arg2);
+};
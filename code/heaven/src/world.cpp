@@ -11,8 +11,12 @@
 
 #include "world.h"
 
+#include <algorithm>
+
 #include "Network/client.h"
 #include "Network/host.h"
+#include "profiler.h"
+#include "trace.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* Static Variables */
@@ -24,16 +28,25 @@ const std::string World::SCENE_LIST_FILE = "Ressources/scene_list.txt",
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* World() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-World::World(sf::RenderWindow* window, Characters::Player* player, State state)
-    : window(window),
+World::World(const sf::Vector2u& size, State state)
+    : size(size),
       grounds(),
       scene_list(),
       state(state),
-      character_factory(this->grounds, this->players, this->window),
+      character_factory(this->grounds, this->players, this->size),
       lower_border(
           new Grounds::SolidGround(sf::FloatRect(0, 1180, 1920, 500))) {
-  addPlayer(player);
   addGround(this->lower_border);
+  setSeed((sf::Uint32)time(0));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* World() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+World::World(sf::RenderWindow* window, Characters::Player* player, State state)
+    : World(window->getSize(), state) {
+  this->window = window;
+  addPlayer(player);
 
   sf::Listener::setPosition(0, player->getPosition().y, 0);
   sf::Listener::setGlobalVolume(50);
@@ -45,6 +58,21 @@ World::World(sf::RenderWindow* window, Characters::Player* player, State state)
 World::World(sf::RenderWindow* window, Characters::Player* player, char* scenes,
              State state)
     : World(window, player, state) {
+  setSceneOrder(scenes);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* World() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+World::World(const sf::Vector2u& size, char* scenes, State state)
+    : World(size, state) {
+  setSceneOrder(scenes);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setSceneOrder() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::setSceneOrder(char* scenes) {
   this->scene_order = new std::vector<std::string>();
   size_t last_index = 0, len = strlen(scenes);
   for (size_t i = 0; i < len; i++) {
@@ -63,9 +91,21 @@ World::World(sf::RenderWindow* window, Characters::Player* player, char* scenes,
 /* update() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 float World::update(float factor) {
+  Profiler::Scope update_scope(Profiler::Phase::Update);
+  this->ground_table_synced = false;
+
+  // Simulation time (factor 1 is 100 ms), expired timers run first
+  this->time_rest += factor * 100.f;
+  sf::Uint32 ms = (sf::Uint32)this->time_rest;
+  this->time_rest -= (float)ms;
+  this->timers.advance(ms);
+
   if (this->state != State::Editor) {
+    Profiler::Scope scope(Profiler::Phase::UpdateScenes);
+
     // Check if all players are higher then currently first loaded scene
-    if (this->current_scenes.size() > 0) {
+    // (not without players, e.g. on a dedicated server)
+    if (this->current_scenes.size() > 0 && this->players.size() > 0) {
       bool scene_done = true;
       scene_t& first_scene = this->current_scenes[0];
       std::vector<Grounds::Ground*>& grounds = std::get<0>(first_scene);
@@ -82,9 +122,8 @@ float World::update(float factor) {
         removeScene(&first_scene);
         this->lower_border->setPosition(sf::Vector2f(0, top));
         // Change pos in network
-        if (this->state == State::Host) {
-          ((Network::Host*)Network::NetworkManager::getInstance())
-              ->doGroundSetPos(this->lower_border);
+        if (getHost()) {
+          getHost()->doGroundSetPos(this->lower_border);
         }
         this->current_scenes.erase(this->current_scenes.begin());
       }
@@ -107,28 +146,42 @@ float World::update(float factor) {
         loadNextScene();
       }
     }
+
+    updateActivation();
   }
 
   if (this->state == State::Local || this->state == State::Host) {
+    Profiler::Scope scope(Profiler::Phase::UpdateCollectables);
+
     // Update Collectables
-    for (auto collectable : this->collectables) collectable->update(factor);
+    for (auto collectable : this->collectables)
+      if (collectable->isAwake()) collectable->update(factor);
 
     // Check collectables for colliding
+    this->collectable_table.sync(
+        this->collectables,
+        [](Collectables::Collectable* c, const sf::FloatRect&) {
+          return c->isAwake();
+        });
     for (auto player : this->players) {
+      sf::FloatRect player_bounds = player->getGlobalBounds();
       // For each collectable
-      for (size_t i = 0; i < this->collectables.size(); i++) {
+      for (size_t i = 0; i < this->collectable_table.size(); i++) {
         // If player intersects with it
-        if (player->getGlobalBounds().intersects(
-                this->collectables[i]->getGlobalBounds())) {
+        if (player_bounds.intersects(this->collectable_table.bounds[i])) {
+          Collectables::Collectable* collectable =
+              this->collectable_table.entities[i];
           // if player wants to collect it
-          if (player->collect(this->collectables[i])) {
+          if (player->collect(collectable)) {
             // Apply to network
-            if (this->state == State::Host) {
-              ((Network::Host*)Network::NetworkManager::getInstance())
-                  ->doCollectableCollected(this->collectables[i], player);
+            if (getHost()) {
+              getHost()->doCollectableCollected(collectable, player);
             }
             // Remove and change i
-            this->collectables.erase(this->collectables.begin() + i);
+            this->collectables.erase(std::find(this->collectables.begin(),
+                                               this->collectables.end(),
+                                               collectable));
+            this->collectable_table.erase(i);
             i--;
           }
         }
@@ -137,22 +190,46 @@ float World::update(float factor) {
   }
 
   // Move enemies
-  for (auto enemy : this->enemies) enemy->update(factor);
-  if (this->state != State::Editor)
-    if (this->enemies.size() > 0) moveEnemies(factor, this->enemies);
+  {
+    Profiler::Scope scope(Profiler::Phase::UpdateEnemies);
+    FrameVector<Characters::Enemy*> awake;
+    awake.reserve(this->enemies.size());
+    for (auto enemy : this->enemies)
+      if (enemy->isAwake()) awake.push_back(enemy);
+
+    // Enemies only read players, anything they do to them is deferred (see
+    // JobSystem). The transform of a sprite is cached on the first read after
+    // a move, so that is done here and not by the jobs at the same time.
+    for (auto player : this->players) player->getGlobalBounds();
+    this->jobs.parallelFor(awake.size(),
+                           [&](size_t i) { awake[i]->update(factor); });
+
+    if (this->state != State::Editor)
+      if (awake.size() > 0) moveEnemies(factor, awake);
+  }
 
   // Move players
-  for (auto player : this->players)
-    player->update(factor);  // Update vertical speed of Player
-  float return_value = movePlayers(factor, this->players);
-
-  // "Contact" with each ground that is contacting a player
-  for (auto c : this->colliding_grounds) {
-    for (auto g : c.second) {
-      g->contact(c.first, factor);
+  float return_value;
+  {
+    Profiler::Scope scope(Profiler::Phase::UpdatePlayers);
+    if (this->state == State::Client && getClient()) {
+      // Main player is moved in fixed steps by the client (prediction)
+      for (auto player : this->players)
+        player->update(player == getPlayer(0) ? 0 : factor);
+      return_value = getClient()->predict(factor);
+    } else {
+      for (auto player : this->players)
+        player->update(factor);  // Update vertical speed of Player
+      return_value = movePlayers(factor, this->players);
     }
   }
 
+  // Begin, stay and end of contacts between characters and grounds
+  {
+    Profiler::Scope scope(Profiler::Phase::UpdateContacts);
+    updateContacts(factor);
+  }
+
 #ifdef DEBUG
   if (this->state != State::Editor)
     // Check if grounds are in correct order
@@ -173,7 +250,8 @@ float World::update(float factor) {
   }
 
   // Host: Check if race has a winner
-  else if (this->state == State::Host && this->race_distance > 0) {
+  else if (this->state == State::Host && this->race_distance > 0 &&
+           this->players.size() > 0) {
     // Get highest player
     Characters::Player* highest_player = getPlayer(0);
     for (auto p : this->players) {
@@ -183,9 +261,7 @@ float World::update(float factor) {
 
     // Check if highest player won
     if (highest_player->getPosition().y < this->race_distance * -100) {
-      ((Network::Host*)Network::NetworkManager::getInstance())
-          ->doDeclareWinner(highest_player,
-                            this->race_clock.getElapsedTime().asMilliseconds());
+      if (getHost()) getHost()->doDeclareWinner(highest_player, getRaceTime());
     }
   }
 
@@ -196,9 +272,18 @@ float World::update(float factor) {
 /* draw() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void World::draw(sf::RenderWindow* window) {
+  // Only the loaded scenes around the view are visible
+  const sf::View& view = window->getView();
+  float view_top = view.getCenter().y - view.getSize().y / 2.f - DRAW_MARGIN,
+        view_bottom =
+            view.getCenter().y + view.getSize().y / 2.f + DRAW_MARGIN;
+
   // Grounds
   if (this->grounds.size() > 0)
     for (size_t i = 0; i < this->grounds.size(); i++) {
+      sf::FloatRect bounds = this->grounds[i]->getGlobalBounds();
+      if (bounds.top > view_bottom || bounds.top + bounds.height < view_top)
+        continue;
       this->grounds[i]->draw(window);
     }
 
@@ -212,6 +297,9 @@ void World::draw(sf::RenderWindow* window) {
   }
 
   for (auto collectable : this->collectables) {
+    sf::FloatRect bounds = collectable->getGlobalBounds();
+    if (bounds.top > view_bottom || bounds.top + bounds.height < view_top)
+      continue;
     collectable->draw(window);
   }
 
@@ -231,11 +319,12 @@ int World::addEnemy(Characters::Enemy* c) {
     if (existing_char == c) return false;
 
   this->enemies.push_back(c);
+  c->setTimers(&this->timers);
+  c->setNetwork(this->network);
 
   // Add to network
-  if (Network::NetworkManager::getInstance() &&
-      Network::NetworkManager::getInstance()->isHost()) {
-    ((Network::Host*)Network::NetworkManager::getInstance())->doAddEnemy(c);
+  if (getHost()) {
+    getHost()->doAddEnemy(c);
   }
 
   if (c->canMove()) c->setMoveDirRight(0);
@@ -253,6 +342,8 @@ int World::addPlayer(Characters::Player* p) {
     if (existing_char == p) return false;
 
   this->players.push_back(p);
+  p->setTimers(&this->timers);
+  p->setNetwork(this->network);
   return index;
 }
 
@@ -262,12 +353,12 @@ int World::addPlayer(Characters::Player* p) {
 int World::addGround(Grounds::Ground* sprite) {
   int index = (int)this->grounds.size();
   this->grounds.push_back(sprite);
+  sprite->setTimers(&this->timers);
+  this->ground_table_synced = false;
 
   // Add to network
-  if (Network::NetworkManager::getInstance() &&
-      Network::NetworkManager::getInstance()->isHost()) {
-    ((Network::Host*)Network::NetworkManager::getInstance())
-        ->doAddGround(sprite);
+  if (getHost()) {
+    getHost()->doAddGround(sprite);
   }
   return index;
 }
@@ -275,118 +366,297 @@ int World::addGround(Grounds::Ground* sprite) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* moveCharacters() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-float World::moveCharacters(float factor,
-                            std::vector<Characters::Character*> characters) {
+float World::moveCharacters(
+    float factor, const FrameVector<Characters::Character*>& characters) {
   float return_value = 0;
+  // Grounds don't change while characters move
+  syncGroundTable();
   for (auto c : characters) {
-    // Skip if character can't move
-    if (!c->canMove()) continue;
-
-    bool colliding_grounds_was_reset = false;
-
-    // ----------------------------------------- //
-    /* Horizontal movement */
-    // ----------------------------------------- //
-
-    sf::FloatRect prev_bounds = c->getGlobalBounds(),
-                  new_bounds = c->getHorizontalMove(factor);
-
-    // Absolute move distance (horizontal)
-    float abs_move_distance = prev_bounds.left - new_bounds.left;
-    if (abs_move_distance < 0.f) abs_move_distance *= -1.f;
-    std::vector<Grounds::Ground*> colliding;  // Stores colliding grounds
-
-    // For loop lowering factor
-    for (float i = 1; i < abs_move_distance; i++) {
-      // Get global bounds for this factor
-      new_bounds = c->getHorizontalMove(factor / i);
-
-      // (Re-)set
-      colliding = std::vector<Grounds::Ground*>();
-
-      // Check if still inside window
-      if (new_bounds.left > 0 &&
-          new_bounds.left + new_bounds.width < this->window->getSize().x) {
-        if (c->canMoveTo(new_bounds, this->grounds, &colliding, nullptr)) {
-          c->horizontalMove(factor / i);
-          // Colliding grounds
-          if (this->colliding_grounds.count(c) == 0)
-            colliding_grounds[c] = std::vector<Grounds::Ground*>();
-          this->colliding_grounds[c] =
-              colliding;  // Overwrite (reset) colliding_grounds
-          colliding_grounds_was_reset = true;
-
-          break;
-        }
-      }
+    // Moved by simulateCharacter() for each received input
+    if (c->isDrivenByInput()) continue;
+    float vert_move_dist = moveCharacter(factor, c);
+    if (this->players.size() > 0 &&
+        c == this->players[0]) {  // Current Character is main Player
+      return_value = vert_move_dist;
     }
+  }
+  return return_value;
+}
 
-    // ----------------------------------------- //
-    /* Vertical movement */
-    // ----------------------------------------- //
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* moveCharacter() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float World::moveCharacter(float factor, Characters::Character* c) {
+  return moveCharacter(factor, c, this->colliding_grounds[c]);
+}
 
-    // Save position of character.
-    // Call moveVertical to move the character.
-    // Check if collision detected
-    //  If yes -> revert changes and try again with smaller factor
-    //  If no -> continue
-    // c->move()
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* moveCharacter() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float World::moveCharacter(float factor, Characters::Character* c,
+                           std::vector<Grounds::Ground*>& collided) {
+  float return_value = 0;
+  // Skip if character can't move
+  if (!c->canMove()) return return_value;
 
-    prev_bounds = c->getGlobalBounds();
-    new_bounds = c->getVerticalMove(factor);
+  bool colliding_grounds_was_reset = false;
 
-    abs_move_distance =
-        prev_bounds.top - new_bounds.top;  // Absolute move distance (vertical)
-    if (abs_move_distance < 0.f) abs_move_distance *= -1.f;
+  // ----------------------------------------- //
+  /* Horizontal movement */
+  // ----------------------------------------- //
 
-    bool* collided_head = new bool;
+  sf::FloatRect prev_bounds = c->getGlobalBounds(),
+                new_bounds = c->getHorizontalMove(factor);
 
-    for (float i = 1; i < abs_move_distance; i++) {
-      // Get global bounds for this factor
-      new_bounds = c->getVerticalMove(factor / i);
+  // Absolute move distance (horizontal)
+  float abs_move_distance = prev_bounds.left - new_bounds.left;
+  if (abs_move_distance < 0.f) abs_move_distance *= -1.f;
+  FrameVector<Grounds::Ground*> colliding;  // Stores colliding grounds
 
-      // (Re-)set
-      colliding = std::vector<Grounds::Ground*>();
+  // For loop lowering factor
+  for (float i = 1; i < abs_move_distance; i++) {
+    // Get global bounds for this factor
+    new_bounds = c->getHorizontalMove(factor / i);
 
-      if (c->canMoveTo(new_bounds, this->grounds, &colliding, collided_head)) {
-        float vert_move_dist = c->verticalMove(factor / i);
+    // (Re-)set
+    colliding.clear();
 
-        // Colliding grounds
-        if (this->colliding_grounds.count(c) == 0)
-          this->colliding_grounds[c] = std::vector<Grounds::Ground*>();
-        if (!colliding_grounds_was_reset)  // If collding_grounds was not
-                                           // reset yet
-          this->colliding_grounds[c] = colliding;  // Overwrite it
-        else  // Else add the new elements to it
-          this->colliding_grounds[c].insert(this->colliding_grounds[c].end(),
-                                            colliding.begin(), colliding.end());
+    // Check if still inside window
+    if (new_bounds.left > 0 &&
+        new_bounds.left + new_bounds.width < this->size.x) {
+      if (c->canMoveTo(new_bounds, this->ground_table, &colliding, nullptr)) {
+        c->horizontalMove(factor / i);
+        // Colliding grounds, overwrite (reset) and keep the capacity
+        collided.assign(colliding.begin(), colliding.end());
+        colliding_grounds_was_reset = true;
 
-        if (c == this->players[0]) {  // Current Character is main Player
-          return_value = vert_move_dist;
-        }
-        if (c->onGround()) {  // Character didn't started jumping but was on
-                              // ground before -> Is falling from something
-          c->setOnGround(false);
-          c->canKeepJumping(false);
-        }
         break;
-      } else {
-        // Check if collision was on head or feet of Character
-        if (*collided_head)
-          c->touchCeiling();
-        else
-          c->touchGround();
       }
     }
-    delete collided_head;
+  }
+
+  // ----------------------------------------- //
+  /* Vertical movement */
+  // ----------------------------------------- //
+
+  // Save position of character.
+  // Call moveVertical to move the character.
+  // Check if collision detected
+  //  If yes -> revert changes and try again with smaller factor
+  //  If no -> continue
+  // c->move()
+
+  prev_bounds = c->getGlobalBounds();
+  new_bounds = c->getVerticalMove(factor);
+
+  abs_move_distance =
+      prev_bounds.top - new_bounds.top;  // Absolute move distance (vertical)
+  if (abs_move_distance < 0.f) abs_move_distance *= -1.f;
+
+  bool collided_head = false;
+
+  for (float i = 1; i < abs_move_distance; i++) {
+    // Get global bounds for this factor
+    new_bounds = c->getVerticalMove(factor / i);
+
+    // (Re-)set
+    colliding.clear();
+
+    if (c->canMoveTo(new_bounds, this->ground_table, &colliding,
+                     &collided_head)) {
+      float vert_move_dist = c->verticalMove(factor / i);
+
+      // Colliding grounds
+      if (!colliding_grounds_was_reset)  // If collding_grounds was not
+                                         // reset yet
+        collided.assign(colliding.begin(), colliding.end());  // Overwrite it
+      else  // Else add the new elements to it
+        collided.insert(collided.end(), colliding.begin(), colliding.end());
+
+      return_value = vert_move_dist;
+      if (c->onGround()) {  // Character didn't started jumping but was on
+                            // ground before -> Is falling from something
+        c->setOnGround(false);
+        c->canKeepJumping(false);
+      }
+      break;
+    } else {
+      // Check if collision was on head or feet of Character
+      if (collided_head)
+        c->touchCeiling();
+      else
+        c->touchGround();
+    }
   }
   return return_value;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* moveEnemies() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::moveEnemies(float factor,
+                        const FrameVector<Characters::Enemy*>& enemies) {
+  // Grounds don't change while enemies move
+  syncGroundTable();
+
+  // The map must not change while the jobs write to the lists
+  FrameVector<std::vector<Grounds::Ground*>*> collided;
+  collided.reserve(enemies.size());
+  for (auto e : enemies) collided.push_back(&this->colliding_grounds[e]);
+
+  this->jobs.parallelFor(enemies.size(), [&](size_t i) {
+    if (!enemies[i]->isDrivenByInput())
+      moveCharacter(factor, enemies[i], *collided[i]);
+  });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* simulateCharacter() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float World::simulateCharacter(Characters::Character* c, float factor) {
+  c->updateMovement(factor);
+  syncGroundTable();
+  return moveCharacter(factor, c);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* updateActivation() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::updateActivation() {
+  this->player_spans.clear();
+  for (auto p : this->players) {
+    sf::FloatRect bounds = p->getGlobalBounds();
+    this->player_spans.emplace_back(bounds.top, bounds.top + bounds.height);
+  }
+
+  // Wake up within activation_distance, sleep beyond it plus SLEEP_MARGIN
+  float sleep_distance = this->activation_distance + SLEEP_MARGIN;
+  for (auto e : this->enemies) {
+    sf::FloatRect bounds = e->getGlobalBounds();
+    float distance = getPlayerDistance(bounds.top, bounds.top + bounds.height);
+    if (e->isAwake()) {
+      if (distance < 0 || distance > sleep_distance) e->setAwake(false);
+    } else if (distance >= 0 && distance <= this->activation_distance) {
+      e->setAwake(true);
+    }
+  }
+  for (auto c : this->collectables) {
+    sf::FloatRect bounds = c->getGlobalBounds();
+    float distance = getPlayerDistance(bounds.top, bounds.top + bounds.height);
+    if (c->isAwake()) {
+      if (distance < 0 || distance > sleep_distance) c->setAwake(false);
+    } else if (distance >= 0 && distance <= this->activation_distance) {
+      c->setAwake(true);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getPlayerDistance() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+float World::getPlayerDistance(float top, float bottom) const {
+  float nearest = -1;
+  for (auto& span : this->player_spans) {
+    float distance = 0;
+    if (span.second < top)
+      distance = top - span.second;
+    else if (span.first > bottom)
+      distance = span.first - bottom;
+    if (nearest < 0 || distance < nearest) nearest = distance;
+  }
+  return nearest;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* syncGroundTable() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::syncGroundTable() {
+  if (this->ground_table_synced) return;
+  this->ground_table_synced = true;
+
+  // Without players (editor, benchmarks) every ground can be hit
+  if (this->state == State::Editor || this->player_spans.empty()) {
+    this->ground_table.sync(this->grounds);
+    return;
+  }
+
+  // Awake characters can't reach grounds that far away
+  float max_distance =
+      this->activation_distance + SLEEP_MARGIN + COLLISION_MARGIN;
+  this->ground_table.sync(
+      this->grounds, [this, max_distance](Grounds::Ground*,
+                                          const sf::FloatRect& bounds) {
+        float distance =
+            getPlayerDistance(bounds.top, bounds.top + bounds.height);
+        return distance <= max_distance;
+      });
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* updateContacts() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::updateContacts(float factor) {
+  // Collected first, the grounds may remove grounds (StartButton)
+  enum class Event : uint8_t { Begin, Stay, End };
+  FrameVector<std::tuple<Event, Characters::Character*, Grounds::Ground*>>
+      events;
+
+  for (auto& c : this->colliding_grounds) {
+    std::vector<Grounds::Ground*>& last = this->contacts[c.first];
+    FrameVector<Grounds::Ground*> current;
+    for (auto g : c.second)
+      if (std::find(current.begin(), current.end(), g) == current.end())
+        current.push_back(g);
+
+    for (auto g : current) {
+      if (std::find(last.begin(), last.end(), g) == last.end())
+        events.emplace_back(Event::Begin, c.first, g);
+      else if (g->hasStayEvents())
+        events.emplace_back(Event::Stay, c.first, g);
+    }
+    for (auto g : last)
+      if (std::find(current.begin(), current.end(), g) == current.end())
+        events.emplace_back(Event::End, c.first, g);
+
+    last.assign(current.begin(), current.end());
+  }
+
+  for (auto& e : events) {
+    Characters::Character* c = std::get<1>(e);
+    Grounds::Ground* g = std::get<2>(e);
+    switch (std::get<0>(e)) {
+      case Event::Begin:
+        g->contactBegin(c, factor);
+        break;
+      case Event::Stay:
+        g->contactStay(c, factor);
+        break;
+      case Event::End:
+        g->contactEnd(c);
+        break;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* forgetGround() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::forgetGround(const Grounds::Ground* ground) {
+  if (ground == this->start_ground) this->start_ground = nullptr;
+  this->ground_table_synced = false;
+  for (auto& c : this->colliding_grounds)
+    c.second.erase(std::remove(c.second.begin(), c.second.end(), ground),
+                   c.second.end());
+  for (auto& c : this->contacts)
+    c.second.erase(std::remove(c.second.begin(), c.second.end(), ground),
+                   c.second.end());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* removeScene */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void World::removeScene(const scene_t* scene) {
+  Trace::Scope trace("removeScene", "scene");
   const std::vector<Grounds::Ground*>& grounds = std::get<0>(*scene);
   const std::vector<Characters::Enemy*>& enemies = std::get<1>(*scene);
   const std::vector<Collectables::Collectable*>& collectables =
@@ -396,13 +666,12 @@ void World::removeScene(const scene_t* scene) {
     for (size_t i = 0; i < this->grounds.size(); i++) {
       if (ground == this->grounds[i]) {
         // Remove from network
-        if (Network::NetworkManager::getInstance() &&
-            Network::NetworkManager::getInstance()->isHost()) {
-          ((Network::Host*)Network::NetworkManager::getInstance())
-              ->doRemoveGround(ground);
+        if (getHost()) {
+          getHost()->doRemoveGround(ground);
         }
         // Remove from  global grounds
         this->grounds.erase(this->grounds.begin() + i);
+        forgetGround(ground);
         delete ground;
         break;
       }
@@ -413,13 +682,12 @@ void World::removeScene(const scene_t* scene) {
     for (size_t i = 0; i < this->enemies.size(); i++) {
       if (enemy == this->enemies[i]) {
         // Remove from network
-        if (Network::NetworkManager::getInstance() &&
-            Network::NetworkManager::getInstance()->isHost()) {
-          ((Network::Host*)Network::NetworkManager::getInstance())
-              ->doRemoveEnemy(enemy);
+        if (getHost()) {
+          getHost()->doRemoveEnemy(enemy);
         }
         // Remove from global enemies
         this->enemies.erase(this->enemies.begin() + i);
+        forgetCharacter(enemy);
         delete enemy;
         break;
       }
@@ -430,9 +698,8 @@ void World::removeScene(const scene_t* scene) {
     for (size_t i = 0; i < this->collectables.size(); i++) {
       if (collec == this->collectables[i]) {
         // Remove from network
-        if (this->state == State::Host) {
-          ((Network::Host*)Network::NetworkManager::getInstance())
-              ->doRemoveCollectable(collec);
+        if (getHost()) {
+          getHost()->doRemoveCollectable(collec);
         }
         // Remove from global collectables
         this->collectables.erase(this->collectables.begin() + i);
@@ -463,6 +730,29 @@ void World::init() {
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* loadResources() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::loadResources() {
+  // The first object of each type loads them
+  sf::Vector2f pos(0, 0);
+  sf::FloatRect rect(0, 0, 100, 100);
+  delete this->character_factory.createCharacter(Characters::Type::Player, pos);
+  delete this->character_factory.createEnemy(Characters::Type::Walker, pos);
+  delete this->character_factory.createEnemy(Characters::Type::Shooter, pos);
+  delete this->collectables_factory.createCollectable(
+      Collectables::Type::Coin, pos);
+  delete this->collectables_factory.createCollectable(
+      Collectables::Type::Heart, pos);
+  delete new Grounds::SolidGround(rect);
+  delete new Grounds::BadGround(rect);
+  delete new Grounds::Portal(rect, pos);
+  delete this->buttons_factory.createButton(
+      Grounds::ButtonType::NetworkButton, pos);
+  delete new Grounds::BuyableButton(pos, Buyables::Type::JumpBoost);
+  Buyables::Factory::getTexture(Buyables::Type::Immortality);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /* loadSceneList() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -494,7 +784,8 @@ void World::loadSceneList() {
 /* loadScene() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 World::scene_t World::loadScene(std::string file, float offset) {
-  sf::Vector2u window_size = this->window->getSize();
+  Trace::Scope trace("loadScene", "scene");
+  sf::Vector2u window_size = this->size;
 #ifdef DEBUG
   std::cout << "New scene file: " << file << std::endl;
   if (file == "Ressources/Scenes/2019_11_21_23_7_52.xml") std::cout << "";
@@ -567,9 +858,13 @@ World::scene_t World::loadScene(std::string file, float offset) {
       // Get ground type
       const char* ground_type = next_box->Attribute("type");
       if (Grounds::ButtonHelper::isButton(std::string(ground_type))) {
-        new_ground = this->buttons_factory.createButton(
+        Grounds::Button* button = this->buttons_factory.createButton(
             Grounds::ButtonHelper::nameToType(std::string(ground_type)),
             sf::Vector2f(rect.left, rect.top));
+        // Removes the start ground of this world
+        if (button && button->getType() == Grounds::ButtonType::StartButton)
+          ((Grounds::StartButton*)button)->setWorld(this);
+        new_ground = button;
         if (!new_ground) {
           if (strcmp(ground_type, "buyable_button") == 0) {
             const char* buyable_type = next_box->Attribute("buyable_type");
@@ -611,7 +906,7 @@ World::scene_t World::loadScene(std::string file, float offset) {
       if (next_box->QueryBoolAttribute("start_ground", &start_ground) ==
           XMLError::XML_SUCCESS)
         if (start_ground) {
-          Grounds::StartButton::setStartGround(this, new_ground);
+          this->start_ground = new_ground;
         }
 
       if (rect.top > 0 && file != SPAWN_SCENE_FILE) {  // Not allowed
@@ -748,6 +1043,7 @@ World::scene_t World::loadScene(std::string file, float offset) {
 /* loadNextScene() */
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void World::loadNextScene() {
+  Trace::Scope trace("loadNextScene", "scene");
   float offset = this->grounds[this->grounds.size() - 1]->getGlobalBounds().top;
 
   if (this->scene_order) {
@@ -756,11 +1052,10 @@ void World::loadNextScene() {
         loadScene(this->scene_order->at(this->scene_index), offset));
     this->scene_index = (this->scene_index + 1) % this->scene_order->size();
   } else {
-    // Random order
-    srand((unsigned int)time(0));
-    int random = rand() % (this->scene_list.size());
+    // Random order (same for same seed)
+    size_t index = this->random() % this->scene_list.size();
 
-    this->current_scenes.push_back(loadScene(this->scene_list[random], offset));
+    this->current_scenes.push_back(loadScene(this->scene_list[index], offset));
   }
 
   scene_t& scene = this->current_scenes[this->current_scenes.size() - 1];
@@ -779,10 +1074,8 @@ int World::addCollectable(Collectables::Collectable* collectable) {
   int index = (int)this->collectables.size();
   this->collectables.push_back(collectable);
   // Add to network
-  if (Network::NetworkManager::getInstance() &&
-      Network::NetworkManager::getInstance()->isHost()) {
-    ((Network::Host*)Network::NetworkManager::getInstance())
-        ->doAddCollectable(collectable);
+  if (getHost()) {
+    getHost()->doAddCollectable(collectable);
   }
   return index;
 }
@@ -792,13 +1085,13 @@ int World::addCollectable(Collectables::Collectable* collectable) {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 void World::toggleAnimation() {
   for (auto e : this->enemies) {
-    e->toggleAnimation();
+    if (e->isAwake()) e->toggleAnimation();
   }
   for (auto p : this->players) {
     p->toggleAnimation();
   }
   for (auto c : this->collectables) {
-    c->toggleAnimation();
+    if (c->isAwake()) c->toggleAnimation();
   }
 }
 
@@ -807,10 +1100,16 @@ void World::toggleAnimation() {
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 std::vector<std::string> World::getLogText() {
   std::vector<std::string> all_logs;
+  if (this->players.size() == 0) return all_logs;
   all_logs.push_back("Speed: " +
                      std::to_string((int)this->players[0]->getVerticalSpeed()));
   all_logs.push_back("y-Position: " +
                      std::to_string((int)this->players[0]->getPosition().y));
+  size_t awake = 0;
+  for (auto e : this->enemies)
+    if (e->isAwake()) awake++;
+  all_logs.push_back("Awake enemies: " + std::to_string(awake) + "/" +
+                     std::to_string(this->enemies.size()));
   for (auto player : this->players) {
     std::vector<std::string> logs = player->getLogText();
     for (std::string& log : logs) all_logs.push_back(log);
@@ -828,10 +1127,15 @@ void World::reset(State state) {
 
   for (auto ground : this->grounds) delete ground;
   this->grounds.clear();
+  this->ground_table_synced = false;
 
   for (auto collectable : this->collectables) delete collectable;
   this->collectables.clear();
 
+  this->colliding_grounds.clear();
+  this->contacts.clear();
+  this->start_ground = nullptr;
+
   this->current_scenes.clear();
 
   sf::Vector2f pos = Characters::Player::START_POSITION;
@@ -860,6 +1164,7 @@ void World::removeGround(const Grounds::Ground* ground) {
   for (size_t i = 0; i < this->grounds.size(); i++)
     if (this->grounds[i] == ground) {
       this->grounds.erase(this->grounds.begin() + i);
+      forgetGround(ground);
       return;
     }
 }
@@ -871,6 +1176,7 @@ void World::removeEnemy(const Characters::Enemy* enemy) {
   for (size_t i = 0; i < this->enemies.size(); i++)
     if (this->enemies[i] == enemy) {
       this->enemies.erase(this->enemies.begin() + i);
+      forgetCharacter((Characters::Character*)enemy);
       return;
     }
 }
@@ -882,10 +1188,33 @@ void World::setRaceDistance(uint16_t distance) {
   this->race_distance = distance;
   if (distance > 0) {
     this->race_destination = sf::RectangleShape(
-        sf::Vector2f((float)this->window->getSize().x, 10.f));
+        sf::Vector2f((float)this->size.x, 10.f));
     this->race_destination.setFillColor(sf::Color(255, 0, 0, 100));
     this->race_destination.setPosition(0, (float)distance * -100.f);
   } else {
     this->race_destination.setSize(sf::Vector2f(0, 0));
   }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* setNetwork() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+void World::setNetwork(Network::NetworkManager* network) {
+  this->network = network;
+  for (auto enemy : this->enemies) enemy->setNetwork(network);
+  for (auto player : this->players) player->setNetwork(network);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getHost() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Network::Host* World::getHost() const {
+  return this->network ? this->network->asHost() : nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+/* getClient() */
+///////////////////////////////////////////////////////////////////////////////////////////////////
+Network::Client* World::getClient() const {
+  return this->network ? this->network->asClient() : nullptr;
 }
\ No newline at end of file
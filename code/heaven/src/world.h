@@ -14,8 +14,10 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/System.hpp>
 #include <SFML/Window.hpp>
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <random>
 
 #include "../tinyxml2/tinyxml2.h"
 #include "Buyables/buyable_factory.h"
@@ -28,6 +30,9 @@
 #include "Grounds/enemy_border.h"
 #include "Grounds/portal.h"
 #include "Grounds/solid_ground.h"
+#include "component_table.h"
+#include "job_system.h"
+#include "timer_wheel.h"
 
 namespace Network {
 class NetworkManager;
@@ -42,6 +47,8 @@ class Client;
  * buttons and so on.
  */
 class World {
+  friend class Bench; /**< Measures the private hot paths (bench.cpp) */
+
  public:
   typedef std::tuple<std::vector<Grounds::Ground*>,
                      std::vector<Characters::Enemy*>,
@@ -63,11 +70,33 @@ class World {
       SCENE_LIST_FILE,  /**< The file path of the scene list file. */
       SPAWN_SCENE_FILE; /**< Scene file for spawn */
 
+  static constexpr float DRAW_MARGIN =
+      200.f; /**< Grounds and collectables this far outside of the view are
+                  still drawn (sprites can be bigger than the bounds) */
+
+  static constexpr float
+      ACTIVATION_DISTANCE = 1500.f, /**< Default vertical distance in px to
+                                         the nearest player at which enemies
+                                         and collectables wake up */
+      SLEEP_MARGIN = 200.f,      /**< They fall asleep this much further away,
+                                      so they don't toggle at the border */
+      COLLISION_MARGIN = 500.f;  /**< Grounds this much further away than
+                                      sleeping entities are left out of
+                                      collision */
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////
   /* Other Variables */
   ///////////////////////////////////////////////////////////////////////////////////////////////////
  private:
   sf::RenderWindow* window = nullptr; /**< A pointer to the window */
+  sf::Vector2u size; /**< Size of the world (size of the window) */
+
+  TimerWheel timers;    /**< Timers of everything in this world, in
+                             simulation time */
+  float time_rest = 0;  /**< Simulation time in ms not yet given to timers */
+  JobSystem jobs;       /**< Updates and moves the enemies in parallel */
+  Network::NetworkManager* network =
+      nullptr; /**< Host or Client of this world, if any (sets itself) */
 
   std::vector<Characters::Enemy*> enemies;  /**< All Enemies of this World.
                                                  Sorted after  y-Pos  */
@@ -80,11 +109,32 @@ class World {
   std::map<Characters::Character*, std::vector<Grounds::Ground*>>
       colliding_grounds; /**< Map for storing the grounds which are currently
                               colliding with the the Players */
+  std::map<Characters::Character*, std::vector<Grounds::Ground*>>
+      contacts; /**< Grounds each Character collided with in the last tick
+                     (without duplicates), to find begin and end of contacts */
   std::vector<Collectables::Collectable*>
       collectables; /**< Vector with all collectables */
 
+  ComponentTable<Grounds::Ground>
+      ground_table; /**< Bounds of grounds for collision, see
+                         syncGroundTable() */
+  bool ground_table_synced =
+      false; /**< Whether ground_table is up to date, reset by each tick and
+                  by adding or removing grounds */
+  ComponentTable<Collectables::Collectable>
+      collectable_table; /**< Bounds of collectables for collecting */
+
+  float activation_distance =
+      ACTIVATION_DISTANCE; /**< See ACTIVATION_DISTANCE */
+  std::vector<std::pair<float, float>>
+      player_spans; /**< Top and bottom of all players, set by
+                         updateActivation() */
+
   State state; /**< Current state */
 
+  Grounds::Ground* start_ground =
+      nullptr; /**< Removed by a StartButton to start the race */
+
   Characters::Factory character_factory;      /**< Factory for characters */
   Collectables::Factory collectables_factory; /**<  Factory for collectables */
   Grounds::ButtonFactory buttons_factory;     /**< Factor for buttons */
@@ -102,8 +152,13 @@ class World {
   std::vector<std::string>* scene_order = nullptr;
   size_t scene_index = 0;
 
+  sf::Uint32 seed;     /**< Seed of random */
+  std::mt19937 random; /**< Chooses scenes if there is no scene_order */
+
   uint16_t race_distance = 0;
-  sf::Clock race_clock;
+  sf::Uint64 race_start = 0;      /**< Simulation time in ms of the start */
+  sf::Int32 race_time_offset = 0; /**< Race time in ms at race_start
+                                  (joined a running race) */
   sf::RectangleShape race_destination;
 
   ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -126,6 +181,27 @@ class World {
 
   World(sf::RenderWindow* window, Characters::Player* player, char* scenes, State state = State::Local);
 
+  /**
+   * @brief Constructs a World without window and players.
+   *
+   * Used by the dedicated server. Players are only added for connected
+   * clients.
+   *
+   * @param size The size of the world, which must be the clients' window size.
+   * @param state The state.
+   */
+  World(const sf::Vector2u& size, State state = State::Host);
+
+  /**
+   * @brief Constructs a World without window and players that loads the given
+   * scenes in order.
+   *
+   * @param size The size of the world, which must be the clients' window size.
+   * @param scenes Comma separated scene files (inside Ressources/Scenes).
+   * @param state The state.
+   */
+  World(const sf::Vector2u& size, char* scenes, State state = State::Host);
+
   /**
    * @brief Destroys the World object.
    *
@@ -173,6 +249,15 @@ class World {
    */
   void init();
 
+  /**
+   * @brief Loads the textures, sounds and fonts shared by all objects of a
+   * type, for every type.
+   *
+   * They are loaded by the first object of a type otherwise. Call it before
+   * worlds are created or updated on more than one thread.
+   */
+  void loadResources();
+
   /** @fn loadScene
    * @brief Loads a scene from file.
    *
@@ -281,18 +366,34 @@ class World {
    * @param p Pointer to the player.
    */
   void deletePlayer(Characters::Player* p) {
-    int16_t index = -1;
-    for (uint8_t i = 0; i < this->players.size(); i++)
-      if (this->players[i] == p) index = i;
-    if (index == -1) return;
-    this->players.erase(this->players.begin() + index);
+    auto it = std::find(this->players.begin(), this->players.end(), p);
+    if (it == this->players.end()) return;
+    this->players.erase(it);
+    forgetCharacter(p);
   }
 
   /**
-   * @brief Restarts the clock for a race.
+   * @brief Moves a single character by one step.
+   *
+   * Applies gravity and jumping before moving like update() does for local
+   * characters. This is used for client side prediction, where the main
+   * player is moved in fixed steps by the client and remote players are
+   * moved by the host whenever an input is received.
+   *
+   * @param c The character to move.
+   * @param factor The time factor of the step.
+   * @return float The vertical movement of c.
    */
-  void startRace() {
-    this->race_clock.restart();
+  float simulateCharacter(Characters::Character* c, float factor);
+
+  /**
+   * @brief Starts the race time.
+   *
+   * @param time The time in ms the race is already running.
+   */
+  void startRace(sf::Int32 time = 0) {
+    this->race_start = this->timers.getTime();
+    this->race_time_offset = time;
     this->started = true;
   }
 
@@ -300,6 +401,13 @@ class World {
   /* Private Methods */
   // ----------------------------------------- //
  private:
+  /**
+   * @brief Sets the order of scenes to load.
+   *
+   * @param scenes Comma separated scene files (inside Ressources/Scenes).
+   */
+  void setSceneOrder(char* scenes);
+
   /** @fn loadSchemeList
    * @brief Reads the SCENE_LIST_FILE and saves all entries into scene_list.
    */
@@ -317,19 +425,42 @@ class World {
    * @return The vertical movement of the Player.
    */
   float moveCharacters(float factor,
-                       std::vector<Characters::Character*> characters);
+                       const FrameVector<Characters::Character*>& characters);
 
   /**
-   * @brief Wrapper for moveCharacters with enemies.
+   * @brief Handles moving for a single Character.
+   *
+   * ground_table must be synced before.
    *
    * @param factor The time factor.
-   * @param enemies The vector of enemies to move.
+   * @param c The character to move.
+   * @return float The vertical movement of c.
    */
-  void moveEnemies(float factor, std::vector<Characters::Enemy*> enemies) {
-    std::vector<Characters::Character*> characters;
-    for (auto e : enemies) characters.push_back(e);
-    moveCharacters(factor, characters);
-  }
+  float moveCharacter(float factor, Characters::Character* c);
+
+  /**
+   * @brief Same as moveCharacter() above, but writes the colliding grounds
+   * to the given list instead of looking it up in colliding_grounds.
+   *
+   * @param factor The time factor.
+   * @param c The character to move.
+   * @param collided The colliding grounds of c.
+   * @return float The vertical movement of c.
+   */
+  float moveCharacter(float factor, Characters::Character* c,
+                      std::vector<Grounds::Ground*>& collided);
+
+  /**
+   * @brief Moves enemies in parallel (see jobs).
+   *
+   * Enemies only collide with grounds, which don't move meanwhile, so each
+   * enemy is independent of the others.
+   *
+   * @param factor The time factor.
+   * @param enemies The awake enemies.
+   */
+  void moveEnemies(float factor,
+                   const FrameVector<Characters::Enemy*>& enemies);
 
   /**
    * @brief Wrapper for moveCharacters with players.
@@ -339,13 +470,67 @@ class World {
    * @return float The value of vertical movement of the main player or 0 if not
    * in players.
    */
-  float movePlayers(float factor, std::vector<Characters::Player*> players) {
-    std::vector<Characters::Character*> characters;
+  float movePlayers(float factor,
+                    const std::vector<Characters::Player*>& players) {
+    FrameVector<Characters::Character*> characters;
+    characters.reserve(players.size());
     for (auto e : players)
       if (e->isLocal()) characters.push_back(e);
     return moveCharacters(factor, characters);
   }
 
+  /**
+   * @brief Wakes up enemies and collectables near players and puts the ones
+   * far away from all players to sleep.
+   *
+   * Sleeping ones are not updated, moved, animated or collected.
+   */
+  void updateActivation();
+
+  /**
+   * @brief Returns the vertical distance to the nearest player.
+   *
+   * @param top Top of the area.
+   * @param bottom Bottom of the area.
+   * @return float The distance in px, 0 if overlapping and negative without
+   * players.
+   */
+  float getPlayerDistance(float top, float bottom) const;
+
+  /**
+   * @brief Syncs ground_table with the grounds near players, once per tick.
+   *
+   * The table stays valid until the next tick, unless a ground is added,
+   * removed or moved (see groundMoved()). So simulating each received input
+   * doesn't read all grounds again.
+   */
+  void syncGroundTable();
+
+  /**
+   * @brief Compares colliding_grounds with the contacts of the last tick and
+   * calls contactBegin(), contactStay() and contactEnd() of the grounds.
+   *
+   * @param factor The time factor.
+   */
+  void updateContacts(float factor);
+
+  /**
+   * @brief Removes a ground from all contacts, without contactEnd().
+   *
+   * @param ground The ground.
+   */
+  void forgetGround(const Grounds::Ground* ground);
+
+  /**
+   * @brief Removes all contacts of a character, without contactEnd().
+   *
+   * @param c The character.
+   */
+  void forgetCharacter(Characters::Character* c) {
+    this->colliding_grounds.erase(c);
+    this->contacts.erase(c);
+  }
+
   /**
    * @brief Removes all grounds, enemies and collectables of this scene from
    * global variables.
@@ -372,12 +557,26 @@ class World {
     return this->collectables;
   }
 
+  /**
+   * @brief Must be called after moving a ground outside of update(), so the
+   * next collision check sees the new position.
+   */
+  void groundMoved() { this->ground_table_synced = false; }
+
   void setGrounds(std::vector<Grounds::Ground*> grounds) {
     this->grounds = grounds;
+    this->ground_table_synced = false;
+    for (auto g : this->grounds) g->setTimers(&this->timers);
+    this->colliding_grounds.clear();
+    this->contacts.clear();
   }
 
   void setEnemies(std::vector<Characters::Enemy*> enemies) {
     this->enemies = enemies;
+    for (auto e : this->enemies) {
+      e->setTimers(&this->timers);
+      e->setNetwork(this->network);
+    }
   }
 
   void setCollectables(std::vector<Collectables::Collectable*> collectables) {
@@ -386,10 +585,16 @@ class World {
 
   void setPlayers(std::vector<Characters::Player*> players) {
     this->players = players;
+    for (auto p : this->players) {
+      p->setTimers(&this->timers);
+      p->setNetwork(this->network);
+    }
   }
 
   sf::RenderWindow* getWindow() { return this->window; }
 
+  const sf::Vector2u& getSize() const { return this->size; }
+
   Characters::Factory* getCharacterFactory() {
     return &this->character_factory;
   }
@@ -400,7 +605,93 @@ class World {
 
   bool isStarted() const { return this->started; }
 
+  /**
+   * @brief Returns the ground that is removed by a StartButton.
+   *
+   * @return Grounds::Ground* The ground or nullptr if there is none (anymore).
+   */
+  Grounds::Ground* getStartGround() const { return this->start_ground; }
+
+  uint16_t getRaceDistance() const { return this->race_distance; }
+
+  /**
+   * @brief Returns the simulation time since the race started.
+   *
+   * @return sf::Uint32 The time in ms.
+   */
+  sf::Uint32 getRaceTime() const {
+    return (sf::Uint32)(this->race_time_offset +
+                        (sf::Int64)(this->timers.getTime() - this->race_start));
+  }
+
+  TimerWheel* getTimers() { return &this->timers; }
+
+  /**
+   * @brief Sets the network of this world and of all its characters. Called
+   * by the NetworkManager itself.
+   *
+   * @param network The Host or Client, nullptr if there is none (anymore).
+   */
+  void setNetwork(Network::NetworkManager* network);
+
+  Network::NetworkManager* getNetwork() const { return this->network; }
+
+  /**
+   * @brief Returns the network of this world if it is a Host.
+   *
+   * @return Network::Host* The host or nullptr.
+   */
+  Network::Host* getHost() const;
+
+  /**
+   * @brief Returns the network of this world if it is a Client.
+   *
+   * @return Network::Client* The client or nullptr.
+   */
+  Network::Client* getClient() const;
+
   void setState(State state) { this->state = state; }
 
+  State getState() const { return this->state; }
+
   void setRaceDistance(uint16_t distance);
+
+  /**
+   * @brief Sets the seed for choosing random scenes.
+   *
+   * Must be set before the first scene is loaded to get the same scenes
+   * again.
+   *
+   * @param seed The seed.
+   */
+  void setSeed(sf::Uint32 seed) {
+    this->seed = seed;
+    this->random.seed(seed);
+  }
+
+  sf::Uint32 getSeed() const { return this->seed; }
+
+  /**
+   * @brief Sets the distance at which enemies and collectables wake up.
+   *
+   * Changes the simulation, so it is part of recordings.
+   *
+   * @param distance The vertical distance in px to the nearest player.
+   */
+  void setActivationDistance(float distance) {
+    this->activation_distance = distance;
+  }
+
+  float getActivationDistance() const { return this->activation_distance; }
+
+  /**
+   * @brief Sets the number of threads that update and move the enemies.
+   *
+   * Doesn't change the simulation, the result is the same for any number.
+   *
+   * @param threads Threads incl. the calling one, 0 for one per core.
+   */
+  void setThreads(unsigned int threads) { this->jobs.setThreads(threads); }
+
+  unsigned int getThreads() const { return this->jobs.getThreads(); }
 };